@@ -0,0 +1,49 @@
+#!/usr/bin/env python
+'''
+Convert MaterialX documents between the XML and binary formats, with the
+format of each file determined by its extension.
+'''
+
+import argparse
+import sys
+
+import MaterialX as mx
+
+def isBinaryFilename(filename):
+    return filename.endswith('.' + mx.MTLX_BINARY_EXTENSION)
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert MaterialX documents between the XML and binary formats.")
+    parser.add_argument("--stdlib", dest="stdlib", action="store_true", help="Convert the standard MaterialX libraries rather than an input document.")
+    parser.add_argument(dest="inputFilename", nargs="?", help="Filename of the input document.")
+    parser.add_argument(dest="outputFilename", help="Filename of the output document.")
+    opts = parser.parse_args()
+
+    doc = mx.createDocument()
+    try:
+        if opts.stdlib:
+            mx.loadLibraries(mx.getDefaultDataLibraryFolders(), mx.getDefaultDataSearchPath(), doc)
+        elif not opts.inputFilename:
+            parser.error("An input filename is required unless --stdlib is specified.")
+        elif isBinaryFilename(opts.inputFilename):
+            readOptions = mx.BinaryReadOptions()
+            readOptions.upgradeVersion = False
+            mx.readFromBinaryFile(doc, opts.inputFilename, mx.FileSearchPath(), readOptions)
+        else:
+            readOptions = mx.XmlReadOptions()
+            readOptions.readComments = True
+            readOptions.readNewlines = True
+            readOptions.upgradeVersion = False
+            mx.readFromXmlFile(doc, opts.inputFilename, mx.FileSearchPath(), readOptions)
+    except mx.Exception as err:
+        print(err)
+        sys.exit(1)
+
+    if isBinaryFilename(opts.outputFilename):
+        mx.writeToBinaryFile(doc, opts.outputFilename)
+    else:
+        mx.writeToXmlFile(doc, opts.outputFilename)
+    print("Wrote %s" % opts.outputFilename)
+
+if __name__ == '__main__':
+    main()
@@ -24,6 +24,9 @@ EMSCRIPTEN_BINDINGS(document)
         .function("initialize", &mx::Document::initialize)
         .function("copy", &mx::Document::copy)
         .function("importLibrary", &mx::Document::importLibrary)
+        .function("setDataLibrary", &mx::Document::setDataLibrary)
+        .function("getDataLibrary", &mx::Document::getDataLibrary)
+        .function("hasDataLibrary", &mx::Document::hasDataLibrary)
         .function("getReferencedSourceUris", ems::optional_override([](mx::Document &self) {
             mx::StringSet set = self.getReferencedSourceUris();
             return ems::val::array(set.begin(), set.end());
@@ -103,6 +106,8 @@ EMSCRIPTEN_BINDINGS(document)
         .function("hasColorManagementConfig", &mx::Document::hasColorManagementConfig)
         .function("getColorManagementConfig", &mx::Document::getColorManagementConfig)
         .function("invalidateCache", &mx::Document::invalidateCache)
+        .function("freeze", &mx::Document::freeze)
+        .function("isFrozen", &mx::Document::isFrozen)
         .class_property("CATEGORY", &mx::Document::CATEGORY)
         .class_property("CMS_ATTRIBUTE", &mx::Document::CMS_ATTRIBUTE)
         .class_property("CMS_CONFIG_ATTRIBUTE", &mx::Document::CMS_CONFIG_ATTRIBUTE);
@@ -0,0 +1,120 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXCore/Arena.h>
+
+#include <algorithm>
+#include <new>
+
+MATERIALX_NAMESPACE_BEGIN
+
+const size_t MemoryArena::DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+//
+// MemoryArena methods
+//
+
+MemoryArena::MemoryArena(size_t blockSize, bool threadSafe) :
+    _threadSafe(threadSafe),
+    _blockSize(std::max(blockSize, GRANULARITY * SIZE_CLASS_COUNT)),
+    _current(nullptr),
+    _remaining(0)
+{
+    std::fill(std::begin(_freeLists), std::end(_freeLists), nullptr);
+}
+
+MemoryArena::~MemoryArena()
+{
+}
+
+size_t MemoryArena::getSizeClass(size_t size, size_t alignment)
+{
+    if (!size || alignment > GRANULARITY)
+    {
+        return SIZE_CLASS_COUNT;
+    }
+    return (size - 1) / GRANULARITY;
+}
+
+void* MemoryArena::allocate(size_t size, size_t alignment)
+{
+    size_t sizeClass = getSizeClass(size, alignment);
+    if (sizeClass >= SIZE_CLASS_COUNT)
+    {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            return ::operator new(size, std::align_val_t(alignment));
+        }
+        return ::operator new(size);
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex, std::defer_lock);
+    if (_threadSafe)
+    {
+        lock.lock();
+    }
+
+    // Reuse a previously deallocated region of the same size class.
+    void* ptr = _freeLists[sizeClass];
+    if (ptr)
+    {
+        _freeLists[sizeClass] = *static_cast<void**>(ptr);
+        return ptr;
+    }
+
+    // Carve a new region from the current block, reserving a new block
+    // when the current one is exhausted.
+    size_t classSize = (sizeClass + 1) * GRANULARITY;
+    if (_remaining < classSize)
+    {
+        _blocks.emplace_back(new char[_blockSize]);
+        _current = _blocks.back().get();
+        _remaining = _blockSize;
+    }
+    ptr = _current;
+    _current += classSize;
+    _remaining -= classSize;
+    return ptr;
+}
+
+void MemoryArena::deallocate(void* ptr, size_t size, size_t alignment)
+{
+    if (!ptr)
+    {
+        return;
+    }
+
+    size_t sizeClass = getSizeClass(size, alignment);
+    if (sizeClass >= SIZE_CLASS_COUNT)
+    {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            ::operator delete(ptr, std::align_val_t(alignment));
+            return;
+        }
+        ::operator delete(ptr);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex, std::defer_lock);
+    if (_threadSafe)
+    {
+        lock.lock();
+    }
+    *static_cast<void**>(ptr) = _freeLists[sizeClass];
+    _freeLists[sizeClass] = ptr;
+}
+
+size_t MemoryArena::getReservedSize() const
+{
+    std::unique_lock<std::mutex> lock(_mutex, std::defer_lock);
+    if (_threadSafe)
+    {
+        lock.lock();
+    }
+    return _blocks.size() * _blockSize;
+}
+
+MATERIALX_NAMESPACE_END
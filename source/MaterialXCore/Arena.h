@@ -0,0 +1,200 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_ARENA_H
+#define MATERIALX_ARENA_H
+
+/// @file
+/// Memory arena and allocator classes
+
+#include <MaterialXCore/Export.h>
+
+#include <mutex>
+
+MATERIALX_NAMESPACE_BEGIN
+
+class MemoryArena;
+
+/// A shared pointer to a MemoryArena
+using MemoryArenaPtr = shared_ptr<MemoryArena>;
+
+/// @class MemoryArena
+/// A pool of memory from which the elements of a document may be allocated.
+///
+/// Memory is reserved from the system in large blocks, which are released
+/// together when the arena is destroyed.  Small allocations are carved from
+/// these blocks, and memory that is deallocated is recycled for subsequent
+/// allocations of the same size class.  Large allocations are passed through
+/// to the system allocator.
+///
+/// By default, an arena synchronizes each allocation and deallocation, so
+/// that it may be shared across threads.  An arena that is only used from a
+/// single thread at a time, such as the arena of a document that is loaded
+/// and edited by one thread, may be created without synchronization.
+class MX_CORE_API MemoryArena : public std::enable_shared_from_this<MemoryArena>
+{
+  public:
+    explicit MemoryArena(size_t blockSize = DEFAULT_BLOCK_SIZE, bool threadSafe = true);
+    ~MemoryArena();
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
+    /// Create a new memory arena.
+    /// @param blockSize The size of the blocks reserved from the system.
+    /// @param threadSafe If true, then the arena may be used from multiple
+    ///    threads concurrently.  If false, then the arena performs no
+    ///    locking, and the caller must ensure that it is used from a single
+    ///    thread at a time, including the destruction of any elements that
+    ///    were allocated from it.  Defaults to true.
+    static MemoryArenaPtr create(size_t blockSize = DEFAULT_BLOCK_SIZE, bool threadSafe = true)
+    {
+        return std::make_shared<MemoryArena>(blockSize, threadSafe);
+    }
+
+    /// Return true if the arena may be used from multiple threads concurrently.
+    bool isThreadSafe() const
+    {
+        return _threadSafe;
+    }
+
+    /// Allocate a region of memory with the given size and alignment.
+    void* allocate(size_t size, size_t alignment);
+
+    /// Deallocate a region of memory that was returned by allocate, with
+    /// the same size and alignment.
+    void deallocate(void* ptr, size_t size, size_t alignment);
+
+    /// Return the total size of the blocks reserved by this arena.
+    size_t getReservedSize() const;
+
+  public:
+    static const size_t DEFAULT_BLOCK_SIZE;
+
+  private:
+    static size_t getSizeClass(size_t size, size_t alignment);
+
+  private:
+    static const size_t GRANULARITY = 16;
+    static const size_t SIZE_CLASS_COUNT = 32;
+
+    mutable std::mutex _mutex;
+    bool _threadSafe;
+    size_t _blockSize;
+    vector<std::unique_ptr<char[]>> _blocks;
+    char* _current;
+    size_t _remaining;
+    void* _freeLists[SIZE_CLASS_COUNT];
+};
+
+/// @class ArenaAllocator
+/// A standard allocator that draws from a MemoryArena, or from the system
+/// allocator if no arena is provided.  The allocator does not own its arena,
+/// and the arena must outlive any memory that is allocated from it.
+template <class T> class ArenaAllocator
+{
+  public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator(MemoryArena* arena = nullptr) noexcept :
+        _arena(arena)
+    {
+    }
+    template <class U> ArenaAllocator(const ArenaAllocator<U>& other) noexcept :
+        _arena(other.getArena())
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        if (_arena)
+        {
+            return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+        }
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* ptr, size_t n)
+    {
+        if (_arena)
+        {
+            _arena->deallocate(ptr, n * sizeof(T), alignof(T));
+            return;
+        }
+        std::allocator<T>().deallocate(ptr, n);
+    }
+
+    /// Return the arena, if any, from which this allocator draws.
+    MemoryArena* getArena() const
+    {
+        return _arena;
+    }
+
+  private:
+    MemoryArena* _arena;
+};
+
+template <class T, class U> bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+    return lhs.getArena() == rhs.getArena();
+}
+
+template <class T, class U> bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+    return lhs.getArena() != rhs.getArena();
+}
+
+/// @class SharedArenaAllocator
+/// A standard allocator that draws from a MemoryArena, holding a shared
+/// reference to the arena.  This allocator is used with std::allocate_shared,
+/// keeping the arena alive for as long as any object allocated from it.
+template <class T> class SharedArenaAllocator
+{
+  public:
+    using value_type = T;
+
+    SharedArenaAllocator(MemoryArenaPtr arena) noexcept :
+        _arena(std::move(arena))
+    {
+    }
+    template <class U> SharedArenaAllocator(const SharedArenaAllocator<U>& other) noexcept :
+        _arena(other.getArena())
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n)
+    {
+        _arena->deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    /// Return the arena from which this allocator draws.
+    const MemoryArenaPtr& getArena() const
+    {
+        return _arena;
+    }
+
+  private:
+    MemoryArenaPtr _arena;
+};
+
+template <class T, class U> bool operator==(const SharedArenaAllocator<T>& lhs, const SharedArenaAllocator<U>& rhs)
+{
+    return lhs.getArena() == rhs.getArena();
+}
+
+template <class T, class U> bool operator!=(const SharedArenaAllocator<T>& lhs, const SharedArenaAllocator<U>& rhs)
+{
+    return lhs.getArena() != rhs.getArena();
+}
+
+MATERIALX_NAMESPACE_END
+
+#endif
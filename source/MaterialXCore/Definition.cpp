@@ -40,7 +40,8 @@ const string AttributeDef::EXPORTABLE_ATTRIBUTE = "exportable";
 
 const string& NodeDef::getType() const
 {
-    const vector<OutputPtr>& activeOutputs = getActiveOutputs();
+    ConstActiveInterfacePtr activeInterface = getActiveInterface();
+    const vector<OutputPtr>& activeOutputs = activeInterface->outputs;
 
     size_t numActiveOutputs = activeOutputs.size();
     if (numActiveOutputs > 1)
@@ -5,7 +5,12 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <atomic>
 #include <mutex>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <unordered_set>
 
 MATERIALX_NAMESPACE_BEGIN
 
@@ -25,116 +30,965 @@ DocumentPtr createDocument()
 // Document cache
 //
 
+namespace
+{
+
+// A process-wide source of definition revisions.  Values are unique across
+// all documents, so that a revision remains distinct when a document
+// switches between data libraries.
+std::atomic<size_t> globalDefinitionRevision(0);
+
+} // anonymous namespace
+
 class Document::Cache
 {
   public:
-    Cache() :
-        valid(false)
+    // An index of the document, which is immutable from the point of view
+    // of readers.  Writers, which may not run concurrently with readers of
+    // the document, update the current snapshot in place.
+    class Snapshot
     {
-    }
-    ~Cache() { }
+      public:
+        // Add the cache entries for a single element.
+        void addElement(Element& elem)
+        {
+            updateElement(elem, true);
+        }
 
-    void refresh()
-    {
-        // Thread synchronization for multiple concurrent readers of a single document.
-        std::lock_guard<std::mutex> guard(mutex);
+        // Remove the cache entries for a single element.
+        void removeElement(Element& elem)
+        {
+            updateElement(elem, false);
+        }
+
+      private:
+        template <class T> static void insertEntry(std::unordered_map<string, vector<T>>& map, const string& key, const T& value)
+        {
+            map[key].push_back(value);
+        }
+
+        template <class T> static void eraseEntry(std::unordered_map<string, vector<T>>& map, const string& key, const T& value)
+        {
+            auto it = map.find(key);
+            if (it == map.end())
+            {
+                return;
+            }
+            vector<T>& entries = it->second;
+            auto entry = std::find(entries.begin(), entries.end(), value);
+            if (entry != entries.end())
+            {
+                entries.erase(entry);
+            }
+            if (entries.empty())
+            {
+                map.erase(it);
+            }
+        }
 
-        if (!valid)
+        template <class T> static void updateEntry(std::unordered_map<string, vector<T>>& map, const string& key, const T& value, bool add)
         {
-            // Clear the existing cache.
-            portElementMap.clear();
-            nodeDefMap.clear();
-            implementationMap.clear();
+            if (add)
+            {
+                insertEntry(map, key, value);
+            }
+            else
+            {
+                eraseEntry(map, key, value);
+            }
+        }
 
-            // Traverse the document to build a new cache.
-            for (ElementPtr elem : doc.lock()->traverseTree())
+        // Shared pointers to the element are acquired only when it has cache
+        // entries, so that elements without entries are visited without
+        // updating reference counts.
+        void updateElement(Element& element, bool add)
+        {
+            const string& nodeName = element.getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
+            const string& nodeGraphName = element.getAttribute(PortElement::NODE_GRAPH_ATTRIBUTE);
+            const string& nodeString = element.getAttribute(NodeDef::NODE_ATTRIBUTE);
+            const string& nodeDefString = element.getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+            if (nodeName.empty() && nodeGraphName.empty() && nodeString.empty() && nodeDefString.empty())
             {
-                const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
-                const string& nodeGraphName = elem->getAttribute(PortElement::NODE_GRAPH_ATTRIBUTE);
-                const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
-                const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+                return;
+            }
+            ElementPtr elem = element.getSelf();
 
-                if (!nodeName.empty())
+            if (!nodeName.empty())
+            {
+                PortElementPtr portElem = elem->asA<PortElement>();
+                if (portElem)
+                {
+                    updateEntry(portElementMap, portElem->getQualifiedName(nodeName), portElem, add);
+                }
+            }
+            else
+            {
+                if (!nodeGraphName.empty())
                 {
                     PortElementPtr portElem = elem->asA<PortElement>();
                     if (portElem)
                     {
-                        portElementMap[portElem->getQualifiedName(nodeName)].push_back(portElem);
+                        updateEntry(portElementMap, portElem->getQualifiedName(nodeGraphName), portElem, add);
                     }
                 }
-                else
+            }
+            if (!nodeString.empty())
+            {
+                NodeDefPtr nodeDef = elem->asA<NodeDef>();
+                if (nodeDef)
                 {
-                    if (!nodeGraphName.empty())
-                    {
-                        PortElementPtr portElem = elem->asA<PortElement>();
-                        if (portElem)
-                        {
-                            portElementMap[portElem->getQualifiedName(nodeGraphName)].push_back(portElem);
-                        }
-                    }
+                    updateEntry(nodeDefMap, nodeDef->getQualifiedName(nodeString), nodeDef, add);
                 }
-                if (!nodeString.empty())
+            }
+            if (!nodeDefString.empty())
+            {
+                InterfaceElementPtr interface = elem->asA<InterfaceElement>();
+                if (interface)
                 {
-                    NodeDefPtr nodeDef = elem->asA<NodeDef>();
-                    if (nodeDef)
+                    if (interface->isA<NodeGraph>())
                     {
-                        nodeDefMap[nodeDef->getQualifiedName(nodeString)].push_back(nodeDef);
+                        updateEntry(implementationMap, interface->getQualifiedName(nodeDefString), interface, add);
                     }
-                }
-                if (!nodeDefString.empty())
-                {
-                    InterfaceElementPtr interface = elem->asA<InterfaceElement>();
-                    if (interface)
+                    ImplementationPtr impl = interface->asA<Implementation>();
+                    if (impl)
                     {
-                        if (interface->isA<NodeGraph>())
-                        {
-                            implementationMap[interface->getQualifiedName(nodeDefString)].push_back(interface);
-                        }
-                        ImplementationPtr impl = interface->asA<Implementation>();
-                        if (impl)
+                        // Check for implementation which specifies a nodegraph as the implementation
+                        const string& nodeGraphString = impl->getNodeGraph();
+                        if (!nodeGraphString.empty())
                         {
-                            // Check for implementation which specifies a nodegraph as the implementation
-                            const string& nodeGraphString = impl->getNodeGraph();
-                            if (!nodeGraphString.empty())
+                            // Track nodegraph references, so that edits to the referenced
+                            // nodegraph can be detected.
+                            if (add)
                             {
-                                NodeGraphPtr nodeGraph = impl->getDocument()->getNodeGraph(nodeGraphString);
-                                if (nodeGraph)
-                                    implementationMap[interface->getQualifiedName(nodeDefString)].push_back(nodeGraph);
+                                nodeGraphReferences[nodeGraphString]++;
                             }
-                            else
+                            else if (--nodeGraphReferences[nodeGraphString] == 0)
                             {
-                                implementationMap[interface->getQualifiedName(nodeDefString)].push_back(interface);
+                                nodeGraphReferences.erase(nodeGraphString);
                             }
+
+                            NodeGraphPtr nodeGraph = impl->getDocument()->getNodeGraph(nodeGraphString);
+                            if (nodeGraph)
+                                updateEntry(implementationMap, interface->getQualifiedName(nodeDefString), InterfaceElementPtr(nodeGraph), add);
+                        }
+                        else
+                        {
+                            updateEntry(implementationMap, interface->getQualifiedName(nodeDefString), interface, add);
                         }
                     }
                 }
             }
+        }
+
+      public:
+        std::unordered_map<string, std::vector<PortElementPtr>> portElementMap;
+        std::unordered_map<string, std::vector<NodeDefPtr>> nodeDefMap;
+        std::unordered_map<string, std::vector<InterfaceElementPtr>> implementationMap;
+        std::unordered_map<string, size_t> nodeGraphReferences;
+    };
+
+    // An index of the nodedefs for each node category, recording the
+    // properties that are compared when resolving nodes to their nodedefs.
+    class NodeDefIndex
+    {
+      public:
+        struct Entry
+        {
+            NodeDefPtr nodeDef;
+            string type;
+            string target;
+            StringSet targets;
+            string version;
+            bool isDefaultVersion;
+            std::unordered_map<string, string> inputTypes;
+        };
+        using EntryVec = vector<Entry>;
+
+        // Build the index entries for the given nodedefs.
+        static std::unique_ptr<const EntryVec> buildEntries(const vector<NodeDefPtr>& nodeDefs)
+        {
+            std::unique_ptr<EntryVec> entries = std::make_unique<EntryVec>();
+            entries->reserve(nodeDefs.size());
+            for (NodeDefPtr nodeDef : nodeDefs)
+            {
+                Entry entry;
+                entry.nodeDef = nodeDef;
+                entry.type = nodeDef->getType();
+                entry.target = nodeDef->getTarget();
+                for (const string& target : splitString(entry.target, ARRAY_VALID_SEPARATORS))
+                {
+                    entry.targets.insert(target);
+                }
+                entry.version = nodeDef->getVersionString();
+                entry.isDefaultVersion = nodeDef->getDefaultVersion();
+                for (InputPtr input : nodeDef->getActiveInputs())
+                {
+                    entry.inputTypes.emplace(input->getName(), input->getType());
+                }
+                entries->push_back(std::move(entry));
+            }
+            return entries;
+        }
+    };
+
+    // An index of the port elements that are connected to each node and
+    // nodegraph, grouped by the qualified name through which they connect.
+    class PortIndex
+    {
+      public:
+        struct Entry
+        {
+            // Ports grouped by their connected node.
+            std::unordered_map<const Element*, vector<PortElementPtr>> nodePorts;
+
+            // Ports grouped by the graph element that contains their parent.
+            std::unordered_map<const Element*, vector<PortElementPtr>> graphPorts;
+        };
+        // Build the index entry for the given ports, which share a single
+        // connected name.
+        static std::unique_ptr<const Entry> buildEntry(const vector<PortElementPtr>& ports)
+        {
+            std::unique_ptr<Entry> entry = std::make_unique<Entry>();
+            for (PortElementPtr port : ports)
+            {
+                NodePtr node = port->getConnectedNode();
+                if (node)
+                {
+                    entry->nodePorts[node.get()].push_back(port);
+                }
+                ElementPtr parent = port->getParent();
+                ElementPtr graph = parent ? parent->getParent() : nullptr;
+                if (graph && graph->isA<GraphElement>())
+                {
+                    entry->graphPorts[graph.get()].push_back(port);
+                }
+            }
+            sortPorts(entry->nodePorts);
+            sortPorts(entry->graphPorts);
+            return entry;
+        }
+
+      private:
+        static void sortPorts(std::unordered_map<const Element*, vector<PortElementPtr>>& map)
+        {
+            for (auto& pair : map)
+            {
+                std::stable_sort(pair.second.begin(), pair.second.end(), [](const ConstElementPtr& a, const ConstElementPtr& b)
+                {
+                    return a->getName() > b->getName();
+                });
+            }
+        }
+    };
+
+    // An index of entries derived from the snapshot, keyed by qualified name.
+    // A table is published to readers in the same manner as the snapshot,
+    // holding a slot for each key of the snapshot map from which its entries
+    // are derived, and each entry is built on first use and published within
+    // its slot.  Lookups of published entries acquire no locks.  Writers
+    // discard the entries of individual keys as their sources change.
+    template <class Entry> class DerivedIndex
+    {
+      public:
+        struct Slot
+        {
+            std::atomic<const Entry*> current { nullptr };
+            std::unique_ptr<const Entry> owned;
+        };
+        using Table = std::unordered_map<string, Slot>;
+
+        // Discard the current table.  This method is called by writers,
+        // which may not run concurrently with readers of the document.
+        void reset()
+        {
+            current.store(nullptr, std::memory_order_release);
+            owned.reset();
+        }
+
+      public:
+        std::atomic<const Table*> current { nullptr };
+        std::unique_ptr<Table> owned;
+    };
+
+    // An index from the name path of each element in the document to the
+    // element, along with the name path of each element, maintained
+    // incrementally by writers as elements are added, removed and renamed.
+    class NamePathIndex
+    {
+      public:
+        // Add the entries for the given element and its descendants.
+        void addElements(ElementPtr elem)
+        {
+            // The name paths of the ancestors of the current element, indexed
+            // by depth within the traversal.
+            auto parentPath = namePaths.find(elem->getParent().get());
+            vector<string> pathStack = { parentPath != namePaths.end() ? parentPath->second : EMPTY_STRING };
+            for (RawTreeIterator it = elem->traverseTreeRaw().begin(); it != RawTreeIterator::end(); ++it)
+            {
+                Element* descendant = it.getElement();
+                pathStack.resize(it.getElementDepth() + 1);
+                const string& parentNamePath = pathStack.back();
+                string namePath = parentNamePath.empty() ? descendant->getName() : parentNamePath + NAME_PATH_SEPARATOR + descendant->getName();
+                elements[namePath] = descendant;
+                namePaths[descendant] = namePath;
+                pathStack.push_back(std::move(namePath));
+            }
+        }
+
+        // Remove the entries for the given element and its descendants.
+        void removeElements(ElementPtr elem)
+        {
+            for (Element* descendant : elem->traverseTreeRaw())
+            {
+                auto it = namePaths.find(descendant);
+                if (it != namePaths.end())
+                {
+                    elements.erase(it->second);
+                    namePaths.erase(it);
+                }
+            }
+        }
+
+      public:
+        // Elements are held through raw pointers, as their entries are
+        // removed before they are detached from the document.
+        std::unordered_map<string, Element*> elements;
+        std::unordered_map<const Element*, string> namePaths;
+    };
+
+  public:
+    Cache() :
+        current(nullptr),
+        structureRevision(0),
+        definitionRevision(0),
+        contentRevision(0)
+    {
+    }
+    ~Cache() { }
+
+    // Return the current snapshot, building a new one if the cache has been
+    // invalidated.  When a valid snapshot is present, this method acquires
+    // no locks, allowing any number of concurrent readers.
+    const Snapshot& get()
+    {
+        const Snapshot* snapshot = current.load(std::memory_order_acquire);
+        if (snapshot)
+        {
+            return *snapshot;
+        }
+
+        // Thread synchronization for multiple concurrent readers of a single document.
+        std::lock_guard<std::mutex> guard(mutex);
+
+        snapshot = current.load(std::memory_order_relaxed);
+        if (!snapshot)
+        {
+            // Traverse the document to build a new snapshot.
+            std::unique_ptr<Snapshot> newSnapshot = std::make_unique<Snapshot>();
+            for (Element* elem : doc.lock()->traverseTreeRaw())
+            {
+                newSnapshot->addElement(*elem);
+            }
 
-            valid = true;
+            // Publish the new snapshot.
+            owned = std::move(newSnapshot);
+            snapshot = owned.get();
+            current.store(snapshot, std::memory_order_release);
         }
+        return *snapshot;
+    }
+
+    // Return the nodedef index entries for the given qualified node category,
+    // or nullptr if no nodedefs are present for the category.  Entries are
+    // built on demand, and are discarded when the definition revision of the
+    // document advances.
+    const NodeDefIndex::EntryVec* getNodeDefEntries(const string& category)
+    {
+        return getDerivedEntry(nodeDefIndex, category, &Snapshot::nodeDefMap, &NodeDefIndex::buildEntries);
+    }
+
+    // Return the port index entry for the given qualified name, or nullptr
+    // if no ports connect through the name.  Entries are built on demand,
+    // and are discarded by writers as the connections through their names
+    // change.
+    const PortIndex::Entry* getPortEntry(const string& name)
+    {
+        return getDerivedEntry(portIndex, name, &Snapshot::portElementMap, &PortIndex::buildEntry);
+    }
+
+    // Build all entries of the nodedef and port indices.  This method is
+    // called before a document is frozen.
+    void buildIndices()
+    {
+        for (const auto& pair : get().nodeDefMap)
+        {
+            getNodeDefEntries(pair.first);
+        }
+        for (const auto& pair : get().portElementMap)
+        {
+            getPortEntry(pair.first);
+        }
+    }
+
+    // Return the entry of the given derived index for the given key, or
+    // nullptr if the snapshot has no sources for the key, building the
+    // table of the index and the entry itself as needed.  The index mutex
+    // is held only while a table or entry is built.
+    template <class Entry, class Source, class BuildFunction>
+    const Entry* getDerivedEntry(DerivedIndex<Entry>& index, const string& key,
+                                 std::unordered_map<string, vector<Source>> Snapshot::*sources,
+                                 BuildFunction buildEntry)
+    {
+        using Table = typename DerivedIndex<Entry>::Table;
+        const Table* table = index.current.load(std::memory_order_acquire);
+        if (table)
+        {
+            auto it = table->find(key);
+            if (it == table->end())
+            {
+                return nullptr;
+            }
+            const Entry* entry = it->second.current.load(std::memory_order_acquire);
+            if (entry)
+            {
+                return entry;
+            }
+        }
+
+        std::lock_guard<std::mutex> guard(indexMutex);
+        const Snapshot& snapshot = get();
+        if (!index.owned)
+        {
+            std::unique_ptr<Table> newTable = std::make_unique<Table>();
+            for (const auto& pair : snapshot.*sources)
+            {
+                (*newTable)[pair.first];
+            }
+            index.owned = std::move(newTable);
+            index.current.store(index.owned.get(), std::memory_order_release);
+        }
+        auto it = index.owned->find(key);
+        if (it == index.owned->end())
+        {
+            return nullptr;
+        }
+        typename DerivedIndex<Entry>::Slot& slot = it->second;
+        if (!slot.owned)
+        {
+            slot.owned = buildEntry((snapshot.*sources).at(key));
+            slot.current.store(slot.owned.get(), std::memory_order_release);
+        }
+        return slot.owned.get();
+    }
+
+    // Discard the entry of the given derived index for the given key, so
+    // that it is rebuilt from the current snapshot on its next use, and
+    // keep the slots of the index in step with the keys of the snapshot.
+    // This method is called by writers after the snapshot has been updated.
+    template <class Entry, class Source>
+    void discardDerivedEntry(DerivedIndex<Entry>& index, const string& key,
+                             std::unordered_map<string, vector<Source>> Snapshot::*sources)
+    {
+        const Snapshot* snapshot = getMutable();
+        if (!index.owned || !snapshot)
+        {
+            return;
+        }
+        if ((snapshot->*sources).count(key))
+        {
+            typename DerivedIndex<Entry>::Slot& slot = (*index.owned)[key];
+            slot.current.store(nullptr, std::memory_order_release);
+            slot.owned.reset();
+        }
+        else
+        {
+            index.owned->erase(key);
+        }
+    }
+
+    // Discard the port index entries that may be affected by an edit to the
+    // given element: the entries for the names through which it connects,
+    // and the entries for the given name of the element, through which
+    // other ports connect to it.
+    void discardPortEntries(const Element& elem, const string& name)
+    {
+        if (!portIndex.owned)
+        {
+            return;
+        }
+        const string& nodeName = elem.getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
+        const string& nodeGraphName = elem.getAttribute(PortElement::NODE_GRAPH_ATTRIBUTE);
+        if (!nodeName.empty())
+        {
+            discardDerivedEntry(portIndex, elem.getQualifiedName(nodeName), &Snapshot::portElementMap);
+        }
+        else if (!nodeGraphName.empty())
+        {
+            discardDerivedEntry(portIndex, elem.getQualifiedName(nodeGraphName), &Snapshot::portElementMap);
+        }
+        if (elem.isA<Node>() || elem.isA<NodeGraph>())
+        {
+            discardDerivedEntry(portIndex, elem.getQualifiedName(name), &Snapshot::portElementMap);
+        }
+        else if (elem.isA<Output>())
+        {
+            // Ports that connect to a nodegraph output resolve to the node
+            // upstream of the output.
+            ConstElementPtr graph = elem.getParent();
+            if (graph && graph->isA<NodeGraph>())
+            {
+                discardDerivedEntry(portIndex, graph->getQualifiedName(graph->getName()), &Snapshot::portElementMap);
+            }
+        }
+    }
+
+    // Mark the top-level element containing the given element for
+    // revalidation, along with all top-level elements downstream of it.
+    // Edits to definitions, or to the document itself, may affect
+    // the validity of any element, and discard all validation results.
+    void markValidationDirty(ConstElementPtr elem)
+    {
+        if (validationResults.empty() || !isAttached(elem))
+        {
+            return;
+        }
+        ConstElementPtr root = doc.lock();
+        ConstElementPtr topLevel = elem;
+        while (topLevel->getParent() && topLevel->getParent() != root)
+        {
+            topLevel = topLevel->getParent();
+        }
+        if (topLevel == root || !isLocallyValidated(topLevel))
+        {
+            validationResults.clear();
+            return;
+        }
+        markValidationDirty(topLevel, topLevel->getName());
+    }
+
+    // Mark the given top-level element for revalidation under the given
+    // name, along with all top-level elements downstream of it, and all
+    // top-level elements that inherit from other elements.  Downstream
+    // elements are included transitively, since the cycle checks of outputs
+    // traverse their entire upstream graph.
+    void markValidationDirty(ConstElementPtr topLevel, const string& name)
+    {
+        if (validationResults.empty())
+        {
+            return;
+        }
+        const Snapshot* snapshot = getMutable();
+        if (!snapshot)
+        {
+            validationResults.clear();
+            return;
+        }
+        validationResults.erase(name);
+        for (const string& inheritingName : inheritingResults)
+        {
+            validationResults.erase(inheritingName);
+        }
+        inheritingResults.clear();
+        ConstElementPtr root = doc.lock();
+        std::unordered_set<string> visited = { name };
+        vector<string> keys = { topLevel->getQualifiedName(name) };
+        while (!keys.empty())
+        {
+            auto ports = snapshot->portElementMap.find(keys.back());
+            keys.pop_back();
+            if (ports == snapshot->portElementMap.end())
+            {
+                continue;
+            }
+            for (ConstElementPtr port : ports->second)
+            {
+                while (port->getParent() && port->getParent() != root)
+                {
+                    port = port->getParent();
+                }
+                if (visited.insert(port->getName()).second)
+                {
+                    validationResults.erase(port->getName());
+                    keys.push_back(port->getQualifiedName(port->getName()));
+                }
+            }
+        }
+    }
+
+    // Return true if the validity of the given top-level element depends
+    // only on its own content and the elements it connects to, allowing its
+    // validation results to be retained across unrelated edits.  Elements
+    // with inheritance depend on the elements they inherit from.
+    static bool isLocallyValidated(ConstElementPtr topLevel)
+    {
+        if (topLevel->hasInheritString())
+        {
+            return false;
+        }
+        if (topLevel->isA<NodeGraph>())
+        {
+            return !topLevel->asA<NodeGraph>()->hasNodeDefString();
+        }
+        return topLevel->isA<Node>();
+    }
+
+    // Return the current snapshot for modification by a writer, or nullptr
+    // if the cache has been invalidated.
+    Snapshot* getMutable()
+    {
+        return current.load(std::memory_order_relaxed) ? owned.get() : nullptr;
+    }
+
+    // Invalidate the current snapshot, along with the indices derived from
+    // it.
+    void invalidate()
+    {
+        current.store(nullptr, std::memory_order_release);
+        nodeDefIndex.reset();
+        portIndex.reset();
+    }
+
+    // Advance the structure revision in response to a structural change.
+    void advanceStructureRevision()
+    {
+        structureRevision++;
+    }
+
+    // Advance the definition revision to a new process-wide value, and
+    // discard the nodedef index.
+    void advanceDefinitionRevision()
+    {
+        definitionRevision.store(++globalDefinitionRevision, std::memory_order_relaxed);
+        nodeDefIndex.reset();
+    }
+
+    // Return true if the given attribute contributes to the structure of
+    // the document, as seen through interface inheritance.
+    static bool isStructuralAttribute(const string& attrib)
+    {
+        return attrib.empty() ||
+               attrib == Element::INHERIT_ATTRIBUTE ||
+               attrib == Element::NAMESPACE_ATTRIBUTE;
+    }
+
+    // Return true if the given attribute contributes to the resolution of
+    // nodes to their nodedefs.
+    static bool isDefinitionAttribute(const string& attrib)
+    {
+        return isStructuralAttribute(attrib) ||
+               attrib == TypedElement::TYPE_ATTRIBUTE ||
+               attrib == NodeDef::NODE_ATTRIBUTE ||
+               attrib == InterfaceElement::NODE_DEF_ATTRIBUTE ||
+               attrib == InterfaceElement::TARGET_ATTRIBUTE ||
+               attrib == InterfaceElement::VERSION_ATTRIBUTE ||
+               attrib == InterfaceElement::DEFAULT_VERSION_ATTRIBUTE;
+    }
+
+    // Return true if edits to the given element may change the nodedef
+    // index, with the element being the document itself, a nodedef, or an
+    // element within a nodedef.
+    static bool isDefinitionElement(ConstElementPtr elem)
+    {
+        if (elem->isA<Document>())
+        {
+            return true;
+        }
+        for (; elem; elem = elem->getParent())
+        {
+            if (elem->isA<NodeDef>())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Return true if the addition or removal of the given element may change
+    // the nodedef index.
+    static bool containsDefinitions(ConstElementPtr elem)
+    {
+        if (isDefinitionElement(elem))
+        {
+            return true;
+        }
+        for (Element* descendant : elem->traverseTreeRaw())
+        {
+            if (descendant->isA<NodeDef>())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Discard the stored nodedef resolutions of the given element, if it is
+    // a node, as edits to its interface may change its matching nodedef.
+    static void discardNodeDefResolution(ElementPtr elem)
+    {
+        NodePtr node = elem ? elem->asA<Node>() : nullptr;
+        if (node)
+        {
+            std::atomic_store(&node->_nodeDefResolution, shared_ptr<const Node::NodeDefResolution>());
+        }
+    }
+
+    // Return true if the given attribute contributes to the connections
+    // between elements.
+    static bool isConnectionAttribute(const string& attrib)
+    {
+        return attrib == PortElement::NODE_NAME_ATTRIBUTE ||
+               attrib == PortElement::NODE_GRAPH_ATTRIBUTE ||
+               attrib == PortElement::OUTPUT_ATTRIBUTE ||
+               attrib == ValueElement::INTERFACE_NAME_ATTRIBUTE;
+    }
+
+    // Return true if the given attribute contributes to cache entries.
+    static bool isCachedAttribute(const string& attrib)
+    {
+        return attrib.empty() ||
+               attrib == PortElement::NODE_NAME_ATTRIBUTE ||
+               attrib == PortElement::NODE_GRAPH_ATTRIBUTE ||
+               attrib == NodeDef::NODE_ATTRIBUTE ||
+               attrib == InterfaceElement::NODE_DEF_ATTRIBUTE ||
+               attrib == Element::NAMESPACE_ATTRIBUTE;
+    }
+
+    // Return true if the given element is currently reachable from the
+    // root of the document.
+    bool isAttached(ConstElementPtr elem) const
+    {
+        ConstElementPtr parent = elem->getParent();
+        while (parent)
+        {
+            if (parent->getChild(elem->getName()) != elem)
+            {
+                return false;
+            }
+            elem = parent;
+            parent = elem->getParent();
+        }
+        return elem == doc.lock();
+    }
+
+    // Return true if the given element is a nodegraph that is referenced by
+    // name from an implementation in the given snapshot.
+    bool isReferencedNodeGraph(const Snapshot& snapshot, ConstElementPtr elem, const string& name) const
+    {
+        return elem->isA<NodeGraph>() &&
+               elem->getParent() == doc.lock() &&
+               snapshot.nodeGraphReferences.count(name);
     }
 
   public:
     weak_ptr<Document> doc;
     std::mutex mutex;
-    bool valid;
-    std::unordered_map<string, std::vector<PortElementPtr>> portElementMap;
-    std::unordered_map<string, std::vector<NodeDefPtr>> nodeDefMap;
-    std::unordered_map<string, std::vector<InterfaceElementPtr>> implementationMap;
+    std::unique_ptr<Snapshot> owned;
+    std::atomic<const Snapshot*> current;
+
+    std::mutex indexMutex;
+    DerivedIndex<NodeDefIndex::EntryVec> nodeDefIndex;
+    DerivedIndex<PortIndex::Entry> portIndex;
+    std::unique_ptr<NamePathIndex> namePathIndex;
+
+    // Validation results for top-level elements, keyed by element name.  An
+    // element without an entry requires revalidation.  Results are also
+    // discarded when the definitions of the data library change.
+    struct ValidationResult
+    {
+        bool valid;
+        string message;
+    };
+    std::mutex validationMutex;
+    std::unordered_map<string, ValidationResult> validationResults;
+    std::unordered_set<string> inheritingResults;
+    ConstDocumentPtr validationLibrary;
+    size_t validationLibraryRevision = 0;
+
+    // Counters that are incremented on changes to the document, allowing
+    // derived data held by elements to detect staleness.
+    std::atomic<size_t> structureRevision;
+    std::atomic<size_t> definitionRevision;
+    std::atomic<size_t> contentRevision;
+};
+
+//
+// Document notifier
+//
+
+class Document::Notifier
+{
+  public:
+    // Report the given change to observers, or record it for the end of the
+    // current transaction.
+    void notify(DocumentPtr doc, DocumentChange::Type type, ElementPtr elem, ElementPtr parent, const string& name)
+    {
+        if (!transactionDepth)
+        {
+            deliver(doc, { DocumentChange(type, elem, parent, name) });
+            return;
+        }
+
+        // Changes within an element that was added in this transaction are
+        // implied by its addition.
+        bool isMembership = (type == DocumentChange::TypeAddElement || type == DocumentChange::TypeRemoveElement);
+        if (isAdded(isMembership ? parent : elem))
+        {
+            return;
+        }
+        if (type == DocumentChange::TypeAddElement)
+        {
+            addedElements.insert(elem.get());
+        }
+        else if (!isMembership && !recordedChanges.emplace(elem.get(), type, name).second)
+        {
+            return;
+        }
+        pendingChanges.emplace_back(type, elem, parent, name);
+    }
+
+    // Report the changes of a completed transaction to observers.
+    void flush(DocumentPtr doc)
+    {
+        DocumentChangeVec changes;
+        changes.swap(pendingChanges);
+        addedElements.clear();
+        recordedChanges.clear();
+        if (!changes.empty())
+        {
+            deliver(doc, changes);
+        }
+    }
+
+  private:
+    void deliver(DocumentPtr doc, const DocumentChangeVec& changes) const
+    {
+        // Iterate over a copy, allowing observers to unregister themselves.
+        vector<DocumentObserverPtr> currentObservers = observers;
+        for (const DocumentObserverPtr& observer : currentObservers)
+        {
+            observer->onChanges(doc, changes);
+        }
+    }
+
+    bool isAdded(ElementPtr elem) const
+    {
+        for (; elem; elem = elem->getParent())
+        {
+            if (addedElements.count(elem.get()))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+  public:
+    vector<DocumentObserverPtr> observers;
+    size_t transactionDepth = 0;
+
+  private:
+    // The changes recorded within the current transaction.  Recorded changes
+    // hold references to their elements, so element addresses remain unique
+    // for the lifetime of the transaction.
+    DocumentChangeVec pendingChanges;
+    std::unordered_set<const Element*> addedElements;
+    std::set<std::tuple<const Element*, DocumentChange::Type, string>> recordedChanges;
 };
 
 //
 // Document methods
 //
 
-Document::Document(ElementPtr parent, const string& name) :
-    GraphElement(parent, CATEGORY, name),
-    _cache(std::make_unique<Cache>())
+Document::Document(ElementPtr parent, const string& name) :
+    GraphElement(parent, CATEGORY, name),
+    _cache(std::make_unique<Cache>()),
+    _notifier(std::make_unique<Notifier>()),
+    _frozen(false)
+{
+}
+
+Document::~Document()
+{
+    // Release attribute storage while the memory arena is still alive.
+    _attributes = AttributeVec();
+}
+
+void Document::setMemoryArena(MemoryArenaPtr arena)
+{
+    getMutableDocument();
+    _attributes = AttributeVec(_attributes.begin(), _attributes.end(), AttributeAllocator(arena.get()));
+    _memoryArena = arena;
+}
+
+void Document::setDataLibrary(ConstDocumentPtr library)
+{
+    getMutableDocument();
+    for (ConstDocumentPtr doc = library; doc; doc = doc->getDataLibrary())
+    {
+        if (doc == getSelf())
+        {
+            throw Exception("Data library cycle detected in document: " + getSourceUri());
+        }
+    }
+    _dataLibrary = library;
+    _cache->advanceStructureRevision();
+    _cache->advanceDefinitionRevision();
+}
+
+void Document::freeze()
+{
+    if (_frozen)
+    {
+        return;
+    }
+
+    // Build all cached data before the document becomes immutable, so that
+    // subsequent lookups never require synchronization.
+    _cache->get();
+    _cache->buildIndices();
+    _frozen = true;
+}
+
+void Document::setNamePathIndexing(bool enable)
+{
+    if (!enable)
+    {
+        _cache->namePathIndex.reset();
+        return;
+    }
+    if (!_cache->namePathIndex)
+    {
+        _cache->namePathIndex = std::make_unique<Cache::NamePathIndex>();
+        for (ElementPtr child : getChildren())
+        {
+            _cache->namePathIndex->addElements(child);
+        }
+    }
+}
+
+bool Document::getNamePathIndexing() const
 {
+    return _cache->namePathIndex != nullptr;
 }
 
-Document::~Document()
+ElementPtr Document::getIndexedElement(const string& namePath) const
+{
+    if (!_cache->namePathIndex)
+    {
+        return nullptr;
+    }
+    auto it = _cache->namePathIndex->elements.find(namePath);
+    return (it != _cache->namePathIndex->elements.end()) ? it->second->getSelf() : nullptr;
+}
+
+const string* Document::getIndexedNamePath(const Element& elem) const
 {
+    if (!_cache->namePathIndex)
+    {
+        return nullptr;
+    }
+    auto it = _cache->namePathIndex->namePaths.find(&elem);
+    return (it != _cache->namePathIndex->namePaths.end()) ? &it->second : nullptr;
 }
 
 void Document::initialize()
@@ -234,6 +1088,7 @@ void Document::importLibrary(const ConstDocumentPtr& library)
         return;
     }
 
+    ScopedTransaction transaction(asA<Document>());
     for (auto child : library->getChildren())
     {
         if (child->getCategory().empty())
@@ -279,7 +1134,7 @@ void Document::importLibrary(const ConstDocumentPtr& library)
 StringSet Document::getReferencedSourceUris() const
 {
     StringSet sourceUris;
-    for (ElementPtr elem : traverseTree())
+    for (Element* elem : traverseTreeRaw())
     {
         if (elem->hasSourceUri())
         {
@@ -301,12 +1156,13 @@ std::pair<int, int> Document::getVersionIntegers() const
 vector<PortElementPtr> Document::getMatchingPorts(const string& nodeName) const
 {
     // Refresh the cache.
-    _cache->refresh();
+    const Cache::Snapshot& cache = _cache->get();
 
     // Return all port elements matching the given node name.
-    if (_cache->portElementMap.count(nodeName))
+    auto it = cache.portElementMap.find(nodeName);
+    if (it != cache.portElementMap.end())
     {
-        return _cache->portElementMap.at(nodeName);
+        return it->second;
     }
     else
     {
@@ -358,37 +1214,128 @@ vector<OutputPtr> Document::getMaterialOutputs() const
 vector<NodeDefPtr> Document::getMatchingNodeDefs(const string& nodeName) const
 {
     // Refresh the cache.
-    _cache->refresh();
+    const Cache::Snapshot& cache = _cache->get();
 
     // Return all nodedefs matching the given node name.
-    if (_cache->nodeDefMap.count(nodeName))
+    vector<NodeDefPtr> nodeDefs;
+    auto it = cache.nodeDefMap.find(nodeName);
+    if (it != cache.nodeDefMap.end())
     {
-        return _cache->nodeDefMap.at(nodeName);
+        nodeDefs = it->second;
     }
-    else
+
+    // Append matching nodedefs from the data library.
+    if (_dataLibrary)
     {
-        return vector<NodeDefPtr>();
+        vector<NodeDefPtr> libraryNodeDefs = _dataLibrary->getMatchingNodeDefs(nodeName);
+        nodeDefs.insert(nodeDefs.end(), libraryNodeDefs.begin(), libraryNodeDefs.end());
     }
+    return nodeDefs;
 }
 
 vector<InterfaceElementPtr> Document::getMatchingImplementations(const string& nodeDef) const
 {
     // Refresh the cache.
-    _cache->refresh();
+    const Cache::Snapshot& cache = _cache->get();
 
     // Return all implementations matching the given nodedef string.
-    if (_cache->implementationMap.count(nodeDef))
+    vector<InterfaceElementPtr> implementations;
+    auto it = cache.implementationMap.find(nodeDef);
+    if (it != cache.implementationMap.end())
     {
-        return _cache->implementationMap.at(nodeDef);
+        implementations = it->second;
     }
-    else
+
+    // Append matching implementations from the data library.
+    if (_dataLibrary)
     {
-        return vector<InterfaceElementPtr>();
+        vector<InterfaceElementPtr> libraryImplementations = _dataLibrary->getMatchingImplementations(nodeDef);
+        implementations.insert(implementations.end(), libraryImplementations.begin(), libraryImplementations.end());
     }
+    return implementations;
 }
 
 bool Document::validate(string* message) const
 {
+    return validate(message, 1);
+}
+
+bool Document::validate(string* message, unsigned int threadCount) const
+{
+    // Validation results are shared by concurrent callers.
+    std::lock_guard<std::mutex> guard(_cache->validationMutex);
+
+    // Discard previous results if the definitions of the data library have
+    // changed since they were computed.
+    size_t libraryRevision = _dataLibrary ? _dataLibrary->getDefinitionRevision() : 0;
+    if (_cache->validationLibrary != _dataLibrary || _cache->validationLibraryRevision != libraryRevision)
+    {
+        _cache->validationResults.clear();
+        _cache->validationLibrary = _dataLibrary;
+        _cache->validationLibraryRevision = libraryRevision;
+    }
+
+    // Gather the top-level children that require validation.
+    const vector<ElementPtr>& children = getChildren();
+    vector<size_t> pending;
+    for (size_t i = 0; i < children.size(); i++)
+    {
+        if (!_cache->validationResults.count(children[i]->getName()))
+        {
+            pending.push_back(i);
+        }
+    }
+
+    // Validate pending children, with each thread claiming the next pending
+    // child, and each child recording its own results.
+    if (!threadCount)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threadCount = (unsigned int) std::min<size_t>(threadCount, pending.size());
+    vector<Cache::ValidationResult> childResults(pending.size());
+    vector<std::exception_ptr> childExceptions(pending.size());
+    std::atomic<size_t> nextChild(0);
+    auto validateChildren = [&]()
+    {
+        for (size_t i = nextChild++; i < pending.size(); i = nextChild++)
+        {
+            try
+            {
+                childResults[i].valid = children[pending[i]]->validate(&childResults[i].message);
+            }
+            catch (...)
+            {
+                childExceptions[i] = std::current_exception();
+            }
+        }
+    };
+    vector<std::thread> threads;
+    for (unsigned int i = 1; i < threadCount; i++)
+    {
+        threads.emplace_back(validateChildren);
+    }
+    validateChildren();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+        if (childExceptions[i])
+        {
+            std::rethrow_exception(childExceptions[i]);
+        }
+        const ElementPtr& child = children[pending[i]];
+        _cache->validationResults[child->getName()] = std::move(childResults[i]);
+        if (child->hasInheritString())
+        {
+            _cache->inheritingResults.insert(child->getName());
+        }
+    }
+
+    // Validate the document element itself, with the checks for each child
+    // drawing upon its retained results.
     bool res = true;
     std::pair<int, int> expectedVersion(MATERIALX_MAJOR_VERSION, MATERIALX_MINOR_VERSION);
     validateRequire(getVersionIntegers() >= expectedVersion, res, message, "Unsupported document version");
@@ -396,9 +1343,446 @@ bool Document::validate(string* message) const
     return GraphElement::validate(message) && res;
 }
 
+bool Document::validateChild(const ElementPtr& child, string* message) const
+{
+    auto it = _cache->validationResults.find(child->getName());
+    if (it == _cache->validationResults.end())
+    {
+        return child->validate(message);
+    }
+    const Cache::ValidationResult& result = it->second;
+    if (message)
+    {
+        *message += result.message;
+    }
+    return result.valid;
+}
+
+void Document::addObserver(DocumentObserverPtr observer)
+{
+    if (std::find(_notifier->observers.begin(), _notifier->observers.end(), observer) == _notifier->observers.end())
+    {
+        _notifier->observers.push_back(observer);
+    }
+}
+
+void Document::removeObserver(DocumentObserverPtr observer)
+{
+    vector<DocumentObserverPtr>& observers = _notifier->observers;
+    observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+}
+
+void Document::beginTransaction()
+{
+    _notifier->transactionDepth++;
+}
+
+void Document::endTransaction()
+{
+    if (!_notifier->transactionDepth)
+    {
+        throw Exception("No transaction is in progress for document: " + getSourceUri());
+    }
+    if (!--_notifier->transactionDepth)
+    {
+        _notifier->flush(asA<Document>());
+    }
+}
+
+bool Document::isInTransaction() const
+{
+    return _notifier->transactionDepth > 0;
+}
+
+size_t Document::getTransactionDepth() const
+{
+    return _notifier->transactionDepth;
+}
+
 void Document::invalidateCache()
 {
-    _cache->valid = false;
+    // The cached data of a frozen document can never become stale.
+    if (_frozen)
+    {
+        return;
+    }
+    _cache->invalidate();
+    _cache->advanceStructureRevision();
+    _cache->advanceDefinitionRevision();
+    _cache->validationResults.clear();
+    if (_cache->namePathIndex)
+    {
+        setNamePathIndexing(false);
+        setNamePathIndexing(true);
+    }
+}
+
+size_t Document::getStructureRevision() const
+{
+    return _cache->structureRevision.load(std::memory_order_relaxed);
+}
+
+size_t Document::getContentRevision() const
+{
+    return _cache->contentRevision.load(std::memory_order_relaxed);
+}
+
+size_t Document::getDefinitionRevision() const
+{
+    // Include the revisions of data libraries, whose definitions may also
+    // be referenced by nodes in this document.  Revisions are drawn from a
+    // process-wide counter, and assigning a data library advances the local
+    // revision, so the maximum over the library chain never repeats a value
+    // with a different set of definitions.
+    size_t revision = _cache->definitionRevision.load(std::memory_order_relaxed);
+    if (_dataLibrary)
+    {
+        revision = std::max(revision, _dataLibrary->getDefinitionRevision());
+    }
+    return revision;
+}
+
+vector<PortElementPtr> Document::getConnectedPorts(const Element& elem) const
+{
+    const Cache::PortIndex::Entry* entry = _cache->getPortEntry(elem.getQualifiedName(elem.getName()));
+    if (!entry)
+    {
+        return vector<PortElementPtr>();
+    }
+    if (elem.isA<Node>())
+    {
+        auto it = entry->nodePorts.find(&elem);
+        return it != entry->nodePorts.end() ? it->second : vector<PortElementPtr>();
+    }
+    auto it = entry->graphPorts.find(elem.getParent().get());
+    return it != entry->graphPorts.end() ? it->second : vector<PortElementPtr>();
+}
+
+NodeDefPtr Document::resolveNodeDef(const Node& node, const string& target, bool allowRoughMatch) const
+{
+    StringSet targets;
+    for (const string& targetName : splitString(target, ARRAY_VALID_SEPARATORS))
+    {
+        targets.insert(targetName);
+    }
+    const string& type = node.getType();
+    const string& version = node.getVersionString();
+    vector<InputPtr> inputs = node.getActiveInputs();
+
+    // Return true if the given entry is a candidate for the node.
+    auto isCandidate = [&](const Cache::NodeDefIndex::Entry& entry)
+    {
+        if (entry.type != type)
+        {
+            return false;
+        }
+        if (entry.version != version && !(entry.isDefaultVersion && version.empty()))
+        {
+            return false;
+        }
+        if (!target.empty() && !entry.target.empty())
+        {
+            bool match = false;
+            for (const string& targetName : targets)
+            {
+                if (entry.targets.count(targetName))
+                {
+                    match = true;
+                    break;
+                }
+            }
+            if (!match)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // Return true if the inputs of the node match those of the given entry.
+    auto isExactMatch = [&](const Cache::NodeDefIndex::Entry& entry)
+    {
+        for (InputPtr input : inputs)
+        {
+            auto it = entry.inputTypes.find(input->getName());
+            if (it == entry.inputTypes.end() || it->second != input->getType())
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // Search the qualified category, followed by the unqualified category,
+    // within this document and its chain of data libraries.
+    const string& category = node.getCategory();
+    const string qualifiedCategory = node.getQualifiedName(category);
+    NodeDefPtr roughMatch;
+    for (const string* candidateCategory : { &qualifiedCategory, &category })
+    {
+        if (candidateCategory == &category && category == qualifiedCategory)
+        {
+            break;
+        }
+        for (const Document* doc = this; doc; doc = doc->_dataLibrary.get())
+        {
+            const Cache::NodeDefIndex::EntryVec* entries = doc->_cache->getNodeDefEntries(*candidateCategory);
+            if (!entries)
+            {
+                continue;
+            }
+            for (const Cache::NodeDefIndex::Entry& entry : *entries)
+            {
+                if (!isCandidate(entry))
+                {
+                    continue;
+                }
+                if (isExactMatch(entry))
+                {
+                    return entry.nodeDef;
+                }
+                if (allowRoughMatch && !roughMatch)
+                {
+                    roughMatch = entry.nodeDef;
+                }
+            }
+        }
+    }
+    return roughMatch;
+}
+
+void Document::onAddElement(ElementPtr elem)
+{
+    _cache->advanceStructureRevision();
+    if (Cache::containsDefinitions(elem))
+    {
+        _cache->advanceDefinitionRevision();
+    }
+    Cache::discardNodeDefResolution(elem->getParent());
+    elem->invalidateContentHash();
+    _cache->contentRevision++;
+    _cache->markValidationDirty(elem);
+    if (_cache->namePathIndex && _cache->isAttached(elem))
+    {
+        _cache->namePathIndex->addElements(elem);
+    }
+
+    Cache::Snapshot* cache = _cache->getMutable();
+    if (cache && _cache->isAttached(elem))
+    {
+        if (_cache->isReferencedNodeGraph(*cache, elem, elem->getName()))
+        {
+            _cache->invalidate();
+        }
+        else
+        {
+            for (Element* descendant : elem->traverseTreeRaw())
+            {
+                cache->addElement(*descendant);
+                _cache->discardPortEntries(*descendant, descendant->getName());
+            }
+        }
+    }
+
+    // Observers are notified once cached data reflects the edit, since they
+    // may query the document from their callbacks.
+    if (!_notifier->observers.empty())
+    {
+        _notifier->notify(asA<Document>(), DocumentChange::TypeAddElement, elem, elem->getParent(), EMPTY_STRING);
+    }
+}
+
+void Document::onRemoveElement(ElementPtr elem, bool beforeChange)
+{
+    // Observers are notified once the element has been detached from its
+    // parent, since they may query the document from their callbacks.
+    if (!beforeChange)
+    {
+        if (!_notifier->observers.empty())
+        {
+            _notifier->notify(asA<Document>(), DocumentChange::TypeRemoveElement, elem, elem->getParent(), EMPTY_STRING);
+        }
+        return;
+    }
+
+    _cache->advanceStructureRevision();
+    if (Cache::containsDefinitions(elem))
+    {
+        _cache->advanceDefinitionRevision();
+    }
+    Cache::discardNodeDefResolution(elem->getParent());
+    elem->invalidateContentHash();
+    _cache->contentRevision++;
+    _cache->markValidationDirty(elem);
+    if (_cache->namePathIndex)
+    {
+        _cache->namePathIndex->removeElements(elem);
+    }
+
+    Cache::Snapshot* cache = _cache->getMutable();
+    if (!cache || !_cache->isAttached(elem))
+    {
+        return;
+    }
+    if (_cache->isReferencedNodeGraph(*cache, elem, elem->getName()))
+    {
+        _cache->invalidate();
+        return;
+    }
+    for (Element* descendant : elem->traverseTreeRaw())
+    {
+        cache->removeElement(*descendant);
+        _cache->discardPortEntries(*descendant, descendant->getName());
+    }
+}
+
+void Document::onRenameElement(ElementPtr elem, const string& oldName)
+{
+    _cache->advanceStructureRevision();
+    if (Cache::isDefinitionElement(elem))
+    {
+        _cache->advanceDefinitionRevision();
+    }
+    Cache::discardNodeDefResolution(elem->getParent());
+    elem->invalidateContentHash();
+    _cache->contentRevision++;
+    if (elem->getParent() == getSelf() && Cache::isLocallyValidated(elem))
+    {
+        _cache->markValidationDirty(elem, oldName);
+    }
+    _cache->markValidationDirty(elem);
+    if (_cache->namePathIndex && _cache->isAttached(elem))
+    {
+        _cache->namePathIndex->removeElements(elem);
+        _cache->namePathIndex->addElements(elem);
+    }
+
+    Cache::Snapshot* cache = _cache->getMutable();
+    if (cache && (_cache->isReferencedNodeGraph(*cache, elem, oldName) ||
+                  _cache->isReferencedNodeGraph(*cache, elem, elem->getName())))
+    {
+        _cache->invalidate();
+    }
+    else if (cache && _cache->isAttached(elem))
+    {
+        // Ports that connect to the element by either name are resolved
+        // again, and the ports of the element are sorted by their names.
+        _cache->discardPortEntries(*elem, oldName);
+        _cache->discardPortEntries(*elem, elem->getName());
+    }
+
+    if (!_notifier->observers.empty())
+    {
+        _notifier->notify(asA<Document>(), DocumentChange::TypeRenameElement, elem, nullptr, oldName);
+    }
+}
+
+void Document::onAttributeChange(ElementPtr elem, const string& attrib, bool beforeChange)
+{
+    _cache->markValidationDirty(elem);
+
+    // Definition attributes are checked both before and after the change,
+    // so that a namespace is detected whether it is being set or cleared.
+    if (Cache::isDefinitionAttribute(attrib))
+    {
+        if (Cache::isDefinitionElement(elem) || attrib == NAMESPACE_ATTRIBUTE || (attrib.empty() && elem->hasNamespace()))
+        {
+            _cache->advanceDefinitionRevision();
+        }
+        Cache::discardNodeDefResolution(elem);
+        Cache::discardNodeDefResolution(elem->getParent());
+    }
+
+    if (!beforeChange)
+    {
+        elem->invalidateContentHash();
+        _cache->contentRevision++;
+        if (attrib.empty() || attrib == ValueElement::VALUE_ATTRIBUTE || attrib == TypedElement::TYPE_ATTRIBUTE)
+        {
+            ValueElementPtr valueElem = elem->asA<ValueElement>();
+            if (valueElem)
+            {
+                std::atomic_store(&valueElem->_parsedValue, ValuePtr());
+            }
+        }
+        if (Cache::isStructuralAttribute(attrib))
+        {
+            _cache->advanceStructureRevision();
+        }
+    }
+
+    Cache::Snapshot* cache = Cache::isCachedAttribute(attrib) ? _cache->getMutable() : nullptr;
+    if (cache && _cache->isAttached(elem))
+    {
+        // Namespace changes affect the qualified names of all descendants, so
+        // we fall back to a full rebuild of the cache.
+        if (attrib == NAMESPACE_ATTRIBUTE || (attrib.empty() && elem->hasNamespace()))
+        {
+            _cache->invalidate();
+        }
+        else if (beforeChange)
+        {
+            cache->removeElement(*elem);
+        }
+        else
+        {
+            cache->addElement(*elem);
+        }
+    }
+
+    // Port index entries are discarded for the names through which the
+    // element connects both before and after the change.
+    if (attrib.empty() || Cache::isConnectionAttribute(attrib))
+    {
+        _cache->discardPortEntries(*elem, elem->getName());
+    }
+
+    if (!beforeChange && !_notifier->observers.empty())
+    {
+        _notifier->notify(asA<Document>(), DocumentChange::TypeAttribute, elem, nullptr, attrib);
+    }
+}
+
+void Document::onChildOrderChange(ElementPtr elem)
+{
+    elem->invalidateContentHash();
+    _cache->contentRevision++;
+    if (!_notifier->observers.empty())
+    {
+        _notifier->notify(asA<Document>(), DocumentChange::TypeChildOrder, elem, nullptr, EMPTY_STRING);
+    }
+}
+
+//
+// ScopedTransaction methods
+//
+
+ScopedTransaction::ScopedTransaction(DocumentPtr doc) :
+    _doc(doc)
+{
+    _doc->beginTransaction();
+    _depth = _doc->getTransactionDepth();
+}
+
+ScopedTransaction::~ScopedTransaction()
+{
+    // The transaction may already have been ended explicitly, in which case
+    // any remaining transactions belong to enclosing scopes.
+    if (_doc->getTransactionDepth() < _depth)
+    {
+        return;
+    }
+
+    // Changes made before an exception remain in the document, so they are
+    // reported even when the scope is exited by unwinding, but exceptions
+    // thrown by observers may not escape the destructor.
+    try
+    {
+        _doc->endTransaction();
+    }
+    catch (...)
+    {
+    }
 }
 
 //
@@ -13,6 +13,7 @@
 
 #include <MaterialXCore/Look.h>
 #include <MaterialXCore/Node.h>
+#include <MaterialXCore/Observer.h>
 
 MATERIALX_NAMESPACE_BEGIN
 
@@ -50,6 +51,7 @@ class MX_CORE_API Document : public GraphElement
     {
         DocumentPtr doc = createDocument<Document>();
         doc->copyContentFrom(getSelf());
+        doc->setDataLibrary(_dataLibrary);
         return doc;
     }
 
@@ -62,6 +64,40 @@ class MX_CORE_API Document : public GraphElement
     /// Get a list of source URI's referenced by the document
     StringSet getReferencedSourceUris() const;
 
+    /// @name Data Library
+    /// @{
+
+    /// Reference the given document as a data library for this document.
+    ///
+    /// Unlike importLibrary, no elements are copied into this document.
+    /// Instead, lookups of definitions by name, such as getNodeDef,
+    /// getTypeDef, getImplementation and getNodeGraph, along with
+    /// getMatchingNodeDefs, getMatchingImplementations and references
+    /// resolved at document scope, fall through to the data library when
+    /// no match is found in this document.  Functions that return all
+    /// elements of a given type, such as getNodeDefs, return only the
+    /// contents of this document.
+    ///
+    /// A single data library may be shared by any number of documents, and
+    /// should not be modified while it is referenced.  Freezing the data
+    /// library allows it to be shared safely across threads.
+    /// @param library The data library to be referenced, or nullptr to
+    ///    remove the current reference.
+    void setDataLibrary(ConstDocumentPtr library);
+
+    /// Return the data library, if any, referenced by this document.
+    ConstDocumentPtr getDataLibrary() const
+    {
+        return _dataLibrary;
+    }
+
+    /// Return true if this document references a data library.
+    bool hasDataLibrary() const
+    {
+        return _dataLibrary != nullptr;
+    }
+
+    /// @}
     /// @name NodeGraph Elements
     /// @{
 
@@ -78,7 +114,7 @@ class MX_CORE_API Document : public GraphElement
     /// Return the NodeGraph, if any, with the given name.
     NodeGraphPtr getNodeGraph(const string& name) const
     {
-        return getChildOfType<NodeGraph>(name);
+        return getDefinitionOfType<NodeGraph>(name);
     }
 
     /// Return a vector of all NodeGraph elements in the document.
@@ -154,7 +190,7 @@ class MX_CORE_API Document : public GraphElement
     /// Return the GeomPropDef, if any, with the given name.
     GeomPropDefPtr getGeomPropDef(const string& name) const
     {
-        return getChildOfType<GeomPropDef>(name);
+        return getDefinitionOfType<GeomPropDef>(name);
     }
 
     /// Return a vector of all GeomPropDef elements in the document.
@@ -289,7 +325,7 @@ class MX_CORE_API Document : public GraphElement
     /// Return the TypeDef, if any, with the given name.
     TypeDefPtr getTypeDef(const string& name) const
     {
-        return getChildOfType<TypeDef>(name);
+        return getDefinitionOfType<TypeDef>(name);
     }
 
     /// Return a vector of all TypeDef elements in the document.
@@ -345,7 +381,7 @@ class MX_CORE_API Document : public GraphElement
     /// Return the NodeDef, if any, with the given name.
     NodeDefPtr getNodeDef(const string& name) const
     {
-        return getChildOfType<NodeDef>(name);
+        return getDefinitionOfType<NodeDef>(name);
     }
 
     /// Return a vector of all NodeDef elements in the document.
@@ -380,7 +416,7 @@ class MX_CORE_API Document : public GraphElement
     /// Return the AttributeDef, if any, with the given name.
     AttributeDefPtr getAttributeDef(const string& name) const
     {
-        return getChildOfType<AttributeDef>(name);
+        return getDefinitionOfType<AttributeDef>(name);
     }
 
     /// Return a vector of all AttributeDef elements in the document.
@@ -412,7 +448,7 @@ class MX_CORE_API Document : public GraphElement
     /// Return the AttributeDef, if any, with the given name.
     TargetDefPtr getTargetDef(const string& name) const
     {
-        return getChildOfType<TargetDef>(name);
+        return getDefinitionOfType<TargetDef>(name);
     }
 
     /// Return a vector of all TargetDef elements in the document.
@@ -508,7 +544,7 @@ class MX_CORE_API Document : public GraphElement
     /// Return the Implementation, if any, with the given name.
     ImplementationPtr getImplementation(const string& name) const
     {
-        return getChildOfType<Implementation>(name);
+        return getDefinitionOfType<Implementation>(name);
     }
 
     /// Return a vector of all Implementation elements in the document.
@@ -544,7 +580,7 @@ class MX_CORE_API Document : public GraphElement
     /// Return the UnitDef, if any, with the given name.
     UnitDefPtr getUnitDef(const string& name) const
     {
-        return getChildOfType<UnitDef>(name);
+        return getDefinitionOfType<UnitDef>(name);
     }
 
     /// Return a vector of all Member elements in the TypeDef.
@@ -575,7 +611,7 @@ class MX_CORE_API Document : public GraphElement
     /// Return the UnitTypeDef, if any, with the given name.
     UnitTypeDefPtr getUnitTypeDef(const string& name) const
     {
-        return getChildOfType<UnitTypeDef>(name);
+        return getDefinitionOfType<UnitTypeDef>(name);
     }
 
     /// Return a vector of all UnitTypeDef elements in the document.
@@ -645,17 +681,126 @@ class MX_CORE_API Document : public GraphElement
         return getAttribute(CMS_CONFIG_ATTRIBUTE);
     }
 
+    /// @}
+    /// @name Memory Arena
+    /// @{
+
+    /// Set the memory arena from which the elements of this document are
+    /// allocated.  Elements that are subsequently added to the document
+    /// draw their storage from the given arena, which remains alive for as
+    /// long as any of these elements.  For best results, this method should
+    /// be called before any content is added to the document.
+    ///
+    /// An arena reduces the number of heap allocations made for elements
+    /// and the cost of destroying a document, while load times remain close
+    /// to those of the system heap, since attribute strings and child maps
+    /// are still allocated from the heap.  When a document is built and
+    /// edited from a single thread, an unsynchronized arena avoids the cost
+    /// of locking on each allocation.
+    /// @param arena The memory arena to be used, or nullptr to allocate
+    ///    new elements from the system heap.
+    void setMemoryArena(MemoryArenaPtr arena);
+
+    /// Return the memory arena from which the elements of this document are
+    /// allocated, if any.
+    MemoryArenaPtr getMemoryArena() const
+    {
+        return _memoryArena;
+    }
+
+    /// @}
+    /// @name Name Path Index
+    /// @{
+
+    /// Enable or disable the name path index of the document.
+    ///
+    /// When enabled, the document maintains an index from the name path of
+    /// each element to the element, together with the name path of each
+    /// element, so that Element::getDescendant and Element::getNamePath
+    /// each require a single hash lookup.  The index is updated as elements
+    /// are added, removed and renamed, at the cost of additional memory and
+    /// of slower edits to the structure of the document.
+    void setNamePathIndexing(bool enable);
+
+    /// Return true if the name path index of the document is enabled.
+    bool getNamePathIndexing() const;
+
+    /// @}
+    /// @name Frozen State
+    /// @{
+
+    /// Freeze the document, placing it in an immutable state.
+    ///
+    /// All derived data used for optimized lookups is computed once, and any
+    /// subsequent attempt to modify the document or its elements throws an
+    /// ExceptionFrozenDocument.  Once frozen, the const accessors of the
+    /// document and its elements may be called concurrently from any number
+    /// of threads without locking.
+    ///
+    /// This method must not be called concurrently with other accessors,
+    /// and a frozen document cannot be unfrozen.  Use copy() to create a
+    /// mutable copy of a frozen document.
+    void freeze();
+
+    /// Return true if the document has been frozen.
+    bool isFrozen() const
+    {
+        return _frozen;
+    }
+
     /// @}
     /// @name Validation
     /// @{
 
     /// Validate that the given document is consistent with the MaterialX
     /// specification.
+    ///
+    /// The results for each top-level element are retained between calls,
+    /// and subsequent calls revalidate only the top-level elements that
+    /// have been edited, along with the elements connected to them.  Edits
+    /// to definitions discard all retained results.
     /// @param message An optional output string, to which a description of
     ///    each error will be appended.
     /// @return True if the document passes all tests, false otherwise.
     bool validate(string* message = nullptr) const override;
 
+    /// Validate the given document using multiple threads, partitioning the
+    /// top-level children of the document across threads.  The results and
+    /// messages are identical to those of serial validation.
+    /// @param message An optional output string, to which a description of
+    ///    each error will be appended.
+    /// @param threadCount The number of threads to use, where a value of
+    ///    zero selects the number of hardware threads.
+    /// @return True if the document passes all tests, false otherwise.
+    bool validate(string* message, unsigned int threadCount) const;
+
+    /// @}
+    /// @name Change Notification
+    /// @{
+
+    /// Register an observer, which will be notified of subsequent changes
+    /// to this document.
+    void addObserver(DocumentObserverPtr observer);
+
+    /// Unregister an observer from this document.
+    void removeObserver(DocumentObserverPtr observer);
+
+    /// Begin a transaction, deferring the notification of observers until
+    /// the matching call to endTransaction.  Transactions may be nested, and
+    /// changes are reported together when the outermost transaction ends.
+    void beginTransaction();
+
+    /// End a transaction, notifying observers of the changes that were made
+    /// within it if this is the outermost transaction.
+    /// @throws Exception if no transaction is in progress.
+    void endTransaction();
+
+    /// Return true if a transaction is in progress.
+    bool isInTransaction() const;
+
+    /// Return the number of nested transactions in progress.
+    size_t getTransactionDepth() const;
+
     /// @}
     /// @name Utility
     /// @{
@@ -677,15 +822,103 @@ class MX_CORE_API Document : public GraphElement
     static const string CMS_ATTRIBUTE;
     static const string CMS_CONFIG_ATTRIBUTE;
 
+  private:
+    // Return the child element, if any, of the given subclass and name,
+    // falling through to the data library if no such child is found.
+    template <class T> shared_ptr<T> getDefinitionOfType(const string& name) const
+    {
+        shared_ptr<T> child = getChildOfType<T>(name);
+        if (!child && _dataLibrary)
+        {
+            child = _dataLibrary->getDefinitionOfType<T>(name);
+        }
+        return child;
+    }
+
+  private:
+    friend class Element;
+    friend class GraphElement;
+    friend class InterfaceElement;
+    friend class Node;
+    friend class NodeGraph;
+
+    // Return a counter that is incremented on each structural change to the
+    // document, including the addition, removal and renaming of elements,
+    // and changes to inheritance and namespace attributes.
+    size_t getStructureRevision() const;
+
+    // Return a counter that is incremented on each edit to the content of
+    // the document.
+    size_t getContentRevision() const;
+
+    // Return a revision that advances on each edit to the nodedefs of the
+    // document or its data libraries, on namespace changes, and on the
+    // assignment of a data library.  Revisions are unique across all
+    // documents in the process.
+    size_t getDefinitionRevision() const;
+
+    // Return the port elements downstream of the given node or nodegraph,
+    // through an index of connections within this document.
+    vector<PortElementPtr> getConnectedPorts(const Element& elem) const;
+
+    // Resolve the given node to its first matching nodedef, through an index
+    // of nodedefs within this document and its data libraries.
+    NodeDefPtr resolveNodeDef(const Node& node, const string& target, bool allowRoughMatch) const;
+
+    // Return the element with the given name path, or the name path of the
+    // given element, through the name path index of this document.  These
+    // methods return nullptr if the index is disabled or has no such entry.
+    ElementPtr getIndexedElement(const string& namePath) const;
+    const string* getIndexedNamePath(const Element& elem) const;
+
+    // Incrementally update cached data in response to edits of the given
+    // element, advancing the structure revision as needed, and notify any
+    // observers of the edit once cached data reflects it.  These methods are
+    // called by Element mutators, and leave the cache untouched when it has
+    // already been invalidated.
+    void onAddElement(ElementPtr elem);
+    void onRemoveElement(ElementPtr elem, bool beforeChange);
+    void onRenameElement(ElementPtr elem, const string& oldName);
+    void onAttributeChange(ElementPtr elem, const string& attrib, bool beforeChange);
+    void onChildOrderChange(ElementPtr elem);
+
+    // Return the retained validation results for the given top-level child.
+    bool validateChild(const ElementPtr& child, string* message) const override;
+
   private:
     class Cache;
+    class Notifier;
     std::unique_ptr<Cache> _cache;
+    std::unique_ptr<Notifier> _notifier;
+    MemoryArenaPtr _memoryArena;
+    ConstDocumentPtr _dataLibrary;
+    bool _frozen;
 };
 
 /// Create a new Document.
 /// @relates Document
 MX_CORE_API DocumentPtr createDocument();
 
+/// @class ScopedTransaction
+/// An RAII class for document transactions, which begins a transaction on
+/// construction and ends it on destruction.
+///
+/// Since documents do not roll back edits, the changes made within the scope
+/// are reported to observers even if the scope is exited by an exception.
+/// Exceptions thrown by observers during destruction are discarded, and a
+/// transaction that has already been ended explicitly is not ended again,
+/// leaving any enclosing transactions open.
+class MX_CORE_API ScopedTransaction
+{
+  public:
+    explicit ScopedTransaction(DocumentPtr doc);
+    ~ScopedTransaction();
+
+  private:
+    DocumentPtr _doc;
+    size_t _depth;
+};
+
 MATERIALX_NAMESPACE_END
 
 #endif
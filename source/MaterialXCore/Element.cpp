@@ -8,7 +8,9 @@
 #include <MaterialXCore/Document.h>
 #include <MaterialXCore/Util.h>
 
+#include <cctype>
 #include <iterator>
+#include <unordered_map>
 
 MATERIALX_NAMESPACE_BEGIN
 
@@ -42,6 +44,183 @@ const string ValueElement::UNIFORM_ATTRIBUTE = "uniform";
 
 Element::CreatorMap Element::_creatorMap;
 
+namespace
+{
+
+const uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+const uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+// Return the 64-bit FNV-1a hash of the given string, which unlike std::hash
+// is identical across platforms and standard libraries.
+uint64_t hashString(const string& str)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (char c : str)
+    {
+        hash ^= (unsigned char) c;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// The standard attribute names of MaterialX.  The handle of each name is
+// the address of an attribute constant holding it, shared by constants with
+// equal names.  The set of names is fixed, so its memory is bounded
+// regardless of input.
+class StandardAttributeNames
+{
+  public:
+    StandardAttributeNames()
+    {
+        const vector<const string*> CONSTANTS = {
+            &NodeDef::NODE_ATTRIBUTE, &NodeDef::NODE_GROUP_ATTRIBUTE, &TypeDef::SEMANTIC_ATTRIBUTE,
+            &TypeDef::CONTEXT_ATTRIBUTE, &Implementation::FILE_ATTRIBUTE, &Implementation::FUNCTION_ATTRIBUTE,
+            &Implementation::NODE_GRAPH_ATTRIBUTE, &UnitDef::UNITTYPE_ATTRIBUTE, &AttributeDef::ATTRNAME_ATTRIBUTE,
+            &AttributeDef::VALUE_ATTRIBUTE, &AttributeDef::ELEMENTS_ATTRIBUTE, &AttributeDef::EXPORTABLE_ATTRIBUTE,
+            &Document::CMS_ATTRIBUTE, &Document::CMS_CONFIG_ATTRIBUTE, &Element::NAME_ATTRIBUTE,
+            &Element::FILE_PREFIX_ATTRIBUTE, &Element::GEOM_PREFIX_ATTRIBUTE, &Element::COLOR_SPACE_ATTRIBUTE,
+            &Element::INHERIT_ATTRIBUTE, &Element::NAMESPACE_ATTRIBUTE, &Element::DOC_ATTRIBUTE, &Element::XPOS_ATTRIBUTE,
+            &Element::YPOS_ATTRIBUTE, &TypedElement::TYPE_ATTRIBUTE, &ValueElement::VALUE_ATTRIBUTE,
+            &ValueElement::INTERFACE_NAME_ATTRIBUTE, &ValueElement::ENUM_ATTRIBUTE,
+            &ValueElement::IMPLEMENTATION_NAME_ATTRIBUTE, &ValueElement::IMPLEMENTATION_TYPE_ATTRIBUTE,
+            &ValueElement::ENUM_VALUES_ATTRIBUTE, &ValueElement::UI_NAME_ATTRIBUTE, &ValueElement::UI_FOLDER_ATTRIBUTE,
+            &ValueElement::UI_MIN_ATTRIBUTE, &ValueElement::UI_MAX_ATTRIBUTE, &ValueElement::UI_SOFT_MIN_ATTRIBUTE,
+            &ValueElement::UI_SOFT_MAX_ATTRIBUTE, &ValueElement::UI_STEP_ATTRIBUTE, &ValueElement::UI_ADVANCED_ATTRIBUTE,
+            &ValueElement::UNIT_ATTRIBUTE, &ValueElement::UNITTYPE_ATTRIBUTE, &ValueElement::UNIFORM_ATTRIBUTE,
+            &GeomElement::GEOM_ATTRIBUTE, &GeomElement::COLLECTION_ATTRIBUTE, &GeomPropDef::GEOM_PROP_ATTRIBUTE,
+            &GeomPropDef::SPACE_ATTRIBUTE, &GeomPropDef::INDEX_ATTRIBUTE, &Collection::INCLUDE_GEOM_ATTRIBUTE,
+            &Collection::EXCLUDE_GEOM_ATTRIBUTE, &Collection::INCLUDE_COLLECTION_ATTRIBUTE,
+            &PortElement::NODE_NAME_ATTRIBUTE, &PortElement::NODE_GRAPH_ATTRIBUTE, &PortElement::OUTPUT_ATTRIBUTE,
+            &InterfaceElement::NODE_DEF_ATTRIBUTE, &InterfaceElement::TARGET_ATTRIBUTE,
+            &InterfaceElement::VERSION_ATTRIBUTE, &InterfaceElement::DEFAULT_VERSION_ATTRIBUTE,
+            &Input::DEFAULT_GEOM_PROP_ATTRIBUTE, &Input::HINT_ATTRIBUTE, &Output::DEFAULT_INPUT_ATTRIBUTE,
+            &MaterialAssign::MATERIAL_ATTRIBUTE, &MaterialAssign::EXCLUSIVE_ATTRIBUTE, &Visibility::VIEWER_GEOM_ATTRIBUTE,
+            &Visibility::VIEWER_COLLECTION_ATTRIBUTE, &Visibility::VISIBILITY_TYPE_ATTRIBUTE,
+            &Visibility::VISIBLE_ATTRIBUTE, &LookGroup::LOOKS_ATTRIBUTE, &LookGroup::ACTIVE_ATTRIBUTE,
+            &Backdrop::CONTAINS_ATTRIBUTE, &Backdrop::WIDTH_ATTRIBUTE, &Backdrop::HEIGHT_ATTRIBUTE,
+            &PropertyAssign::PROPERTY_ATTRIBUTE, &PropertyAssign::GEOM_ATTRIBUTE, &PropertyAssign::COLLECTION_ATTRIBUTE,
+            &PropertySetAssign::PROPERTY_SET_ATTRIBUTE, &VariantAssign::VARIANT_SET_ATTRIBUTE,
+            &VariantAssign::VARIANT_ATTRIBUTE
+        };
+        for (const string* constant : CONSTANTS)
+        {
+            const string* handle = _names.emplace(*constant, constant).first->second;
+            _handles.emplace(constant, handle);
+        }
+    }
+
+    // Return the handle of the given attribute name if it is a standard
+    // name, or nullptr otherwise.  Names passed through their attribute
+    // constants are resolved by address alone.
+    const string* find(const string& name) const
+    {
+        auto handle = _handles.find(&name);
+        if (handle != _handles.end())
+        {
+            return handle->second;
+        }
+        auto it = _names.find(name);
+        return (it != _names.end()) ? it->second : nullptr;
+    }
+
+  private:
+    std::unordered_map<const string*, const string*> _handles;
+    std::unordered_map<string, const string*> _names;
+};
+
+const string* findStandardAttributeName(const string& name)
+{
+    static const StandardAttributeNames STANDARD_NAMES;
+    return STANDARD_NAMES.find(name);
+}
+
+// Return the stored attribute in the given range with the given name, whose
+// standard name handle, if any, has already been resolved.
+template <class Iterator> Iterator findAttributeInRange(Iterator begin, Iterator end, const string& attrib, const string* standardName)
+{
+    if (standardName)
+    {
+        while (begin != end && begin->first.getStandardName() != standardName)
+        {
+            ++begin;
+        }
+        return begin;
+    }
+    while (begin != end && (begin->first.getStandardName() || begin->first.str() != attrib))
+    {
+        ++begin;
+    }
+    return begin;
+}
+
+// Combine a hash value with an existing seed, mixing the result so that
+// small differences in either input affect all bits of the output.
+uint64_t combineHash(uint64_t seed, uint64_t value)
+{
+    uint64_t hash = seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+bool isUiAttribute(const string& attrib)
+{
+    return attrib == Element::XPOS_ATTRIBUTE ||
+           attrib == Element::YPOS_ATTRIBUTE ||
+           attrib == Element::DOC_ATTRIBUTE ||
+           attrib == ValueElement::UI_NAME_ATTRIBUTE ||
+           attrib == ValueElement::UI_FOLDER_ATTRIBUTE ||
+           attrib == ValueElement::UI_ADVANCED_ATTRIBUTE;
+}
+
+// Combine the content hashes of the nodegraph interface inputs referenced
+// by the given element or its inputs.
+uint64_t combineInterfaceHashes(uint64_t hash, ElementPtr elem, bool excludeUiAttributes)
+{
+    vector<InputPtr> inputs;
+    if (elem->isA<Input>())
+    {
+        inputs.push_back(elem->asA<Input>());
+    }
+    else
+    {
+        inputs = elem->getChildrenOfType<Input>();
+    }
+    for (const InputPtr& input : inputs)
+    {
+        InputPtr interfaceInput = input->hasInterfaceName() ? input->getInterfaceInput() : nullptr;
+        if (interfaceInput)
+        {
+            hash = combineHash(hash, interfaceInput->getContentHash(excludeUiAttributes));
+        }
+    }
+    return hash;
+}
+
+const size_t MAX_NAME_SUFFIX_DIGITS = 9;
+
+// Split the given name into a prefix and a numeric suffix, returning false
+// if the name has no suffix that is written in canonical decimal form.
+bool splitNameSuffix(const string& name, string& prefix, int& suffix)
+{
+    size_t split = name.length();
+    while (split > 0 && isdigit(name[split - 1]))
+    {
+        split--;
+    }
+    size_t digits = name.length() - split;
+    if (!digits || digits > MAX_NAME_SUFFIX_DIGITS || (digits > 1 && name[split] == '0'))
+    {
+        return false;
+    }
+    prefix = name.substr(0, split);
+    suffix = std::stoi(name.substr(split));
+    return true;
+}
+
+} // anonymous namespace
+
 //
 // Element methods
 //
@@ -54,15 +233,18 @@ bool Element::operator==(const Element& rhs) const
         return false;
     }
 
-    // Compare attributes.
-    if (getAttributeNames() != rhs.getAttributeNames())
-        return false;
-    for (const string& attr : rhs.getAttributeNames())
+    // Elements with different cached content hashes cannot be equal.
+    uint64_t hash = _contentHash.load(std::memory_order_relaxed);
+    uint64_t rhsHash = rhs._contentHash.load(std::memory_order_relaxed);
+    if (hash && rhsHash && hash != rhsHash)
     {
-        if (getAttribute(attr) != rhs.getAttribute(attr))
-            return false;
+        return false;
     }
 
+    // Compare attributes.
+    if (_attributes != rhs._attributes)
+        return false;
+
     // Compare children.
     const vector<ElementPtr>& c1 = getChildren();
     const vector<ElementPtr>& c2 = rhs.getChildren();
@@ -81,22 +263,36 @@ bool Element::operator!=(const Element& rhs) const
     return !(*this == rhs);
 }
 
+void Element::setCategory(const string& category)
+{
+    DocumentPtr doc = getMutableDocument();
+    doc->onAttributeChange(getSelf(), EMPTY_STRING, true);
+
+    _category = category;
+
+    doc->onAttributeChange(getSelf(), EMPTY_STRING, false);
+}
+
 void Element::setName(const string& name)
 {
+    DocumentPtr doc = getMutableDocument();
     ElementPtr parent = getParent();
     if (parent && parent->_childMap.count(name) && name != getName())
     {
         throw Exception("Element name is not unique at the given scope: " + name);
     }
 
-    getDocument()->invalidateCache();
-
+    const string oldName = getName();
     if (parent)
     {
-        parent->_childMap.erase(getName());
+        parent->_childMap.erase(oldName);
+        parent->removeChildNameSuffix(oldName);
         parent->_childMap[name] = getSelf();
+        parent->addChildNameSuffix(name);
     }
     _name = name;
+
+    doc->onRenameElement(getSelf(), oldName);
 }
 
 string Element::getNamePath(ConstElementPtr relativeTo) const
@@ -106,6 +302,26 @@ string Element::getNamePath(ConstElementPtr relativeTo) const
         relativeTo = getDocument();
     }
 
+    // Look up the name path through the name path index of the document,
+    // if enabled.
+    ElementPtr root = _root.lock();
+    ConstDocumentPtr doc = root ? root->asA<Document>() : nullptr;
+    const string* namePath = doc ? doc->getIndexedNamePath(*this) : nullptr;
+    if (namePath)
+    {
+        if (relativeTo == doc)
+        {
+            return *namePath;
+        }
+        const string* relativePath = doc->getIndexedNamePath(*relativeTo);
+        if (relativePath && namePath->size() > relativePath->size() &&
+            namePath->compare(0, relativePath->size(), *relativePath) == 0 &&
+            namePath->compare(relativePath->size(), NAME_PATH_SEPARATOR.size(), NAME_PATH_SEPARATOR) == 0)
+        {
+            return namePath->substr(relativePath->size() + NAME_PATH_SEPARATOR.size());
+        }
+    }
+
     string res;
     for (ConstElementPtr elem = getSelf(); elem; elem = elem->getParent())
     {
@@ -120,6 +336,25 @@ string Element::getNamePath(ConstElementPtr relativeTo) const
 
 ElementPtr Element::getDescendant(const string& namePath) const
 {
+    // Look up well-formed paths through the name path index of the
+    // document, if enabled.
+    ElementPtr root = _root.lock();
+    ConstDocumentPtr doc = root ? root->asA<Document>() : nullptr;
+    if (doc && doc->getNamePathIndexing() && !namePath.empty() &&
+        namePath.front() != NAME_PATH_SEPARATOR[0] && namePath.back() != NAME_PATH_SEPARATOR[0] &&
+        namePath.find(NAME_PATH_SEPARATOR + NAME_PATH_SEPARATOR) == string::npos)
+    {
+        if (doc.get() == this)
+        {
+            return doc->getIndexedElement(namePath);
+        }
+        const string* parentPath = doc->getIndexedNamePath(*this);
+        if (parentPath)
+        {
+            return doc->getIndexedElement(*parentPath + NAME_PATH_SEPARATOR + namePath);
+        }
+    }
+
     const StringVec nameVec = splitString(namePath, NAME_PATH_SEPARATOR);
     ElementPtr elem = getSelfNonConst();
     for (const string& name : nameVec)
@@ -133,21 +368,113 @@ ElementPtr Element::getDescendant(const string& namePath) const
     return elem;
 }
 
+string Element::createValidChildName(string name) const
+{
+    name = name.empty() ? "_" : createValidName(name);
+    if (!_childMap.count(name))
+    {
+        return name;
+    }
+
+    // Find the suffix from which incrementName would begin its search.
+    size_t split = name.length();
+    while (split > 0 && isdigit(name[split - 1]))
+    {
+        split--;
+    }
+    if (name.length() - split > MAX_NAME_SUFFIX_DIGITS)
+    {
+        while (_childMap.count(name))
+        {
+            name = incrementName(name);
+        }
+        return name;
+    }
+    const string prefix = name.substr(0, split);
+    int suffix = (split < name.length()) ? std::stoi(name.substr(split)) + 1 : 2;
+
+    // Skip past the range of suffixes that are known to be taken.
+    auto it = _childNameSuffixes.find(prefix);
+    if (it != _childNameSuffixes.end() && it->second.first <= suffix && suffix < it->second.second)
+    {
+        suffix = it->second.second;
+    }
+    while (_childMap.count(prefix + std::to_string(suffix)))
+    {
+        suffix++;
+    }
+    return prefix + std::to_string(suffix);
+}
+
 void Element::registerChildElement(ElementPtr child)
 {
-    getDocument()->invalidateCache();
+    DocumentPtr doc = getMutableDocument();
 
     _childMap[child->getName()] = child;
     _childOrder.push_back(child);
+    addChildNameSuffix(child->getName());
+
+    doc->onAddElement(child);
 }
 
 void Element::unregisterChildElement(ElementPtr child)
 {
-    getDocument()->invalidateCache();
+    DocumentPtr doc = getMutableDocument();
+    doc->onRemoveElement(child, true);
 
     _childMap.erase(child->getName());
+    removeChildNameSuffix(child->getName());
     _childOrder.erase(
         std::find(_childOrder.begin(), _childOrder.end(), child));
+
+    doc->onRemoveElement(child, false);
+}
+
+void Element::addChildNameSuffix(const string& name)
+{
+    string prefix;
+    int suffix;
+    if (!splitNameSuffix(name, prefix, suffix))
+    {
+        return;
+    }
+
+    // Extend the range of the prefix when the new suffix is adjacent to it,
+    // absorbing any existing children that follow.
+    std::pair<int, int>& range = _childNameSuffixes.emplace(prefix, std::make_pair(suffix, suffix)).first->second;
+    if (suffix == range.first - 1)
+    {
+        range.first = suffix;
+    }
+    else if (suffix == range.second)
+    {
+        range.second++;
+        while (_childMap.count(prefix + std::to_string(range.second)))
+        {
+            range.second++;
+        }
+    }
+}
+
+void Element::removeChildNameSuffix(const string& name)
+{
+    string prefix;
+    int suffix;
+    if (!splitNameSuffix(name, prefix, suffix))
+    {
+        return;
+    }
+
+    // Truncate the range of the prefix at the removed suffix.
+    auto it = _childNameSuffixes.find(prefix);
+    if (it != _childNameSuffixes.end() && it->second.first <= suffix && suffix < it->second.second)
+    {
+        it->second.second = suffix;
+        if (it->second.first == it->second.second)
+        {
+            _childNameSuffixes.erase(it);
+        }
+    }
 }
 
 int Element::getChildIndex(const string& name) const
@@ -163,6 +490,8 @@ int Element::getChildIndex(const string& name) const
 
 void Element::setChildIndex(const string& name, int index)
 {
+    DocumentPtr doc = getMutableDocument();
+
     ElementPtr child = getChild(name);
     vector<ElementPtr>::iterator it = std::find(_childOrder.begin(), _childOrder.end(), child);
     if (it == _childOrder.end())
@@ -177,6 +506,8 @@ void Element::setChildIndex(const string& name, int index)
 
     _childOrder.erase(it);
     _childOrder.insert(_childOrder.begin() + (size_t) index, child);
+
+    doc->onChildOrderChange(getSelf());
 }
 
 void Element::removeChild(const string& name)
@@ -192,25 +523,34 @@ void Element::removeChild(const string& name)
 
 void Element::setAttribute(const string& attrib, const string& value)
 {
-    getDocument()->invalidateCache();
+    DocumentPtr doc = getMutableDocument();
+    doc->onAttributeChange(getSelf(), attrib, true);
 
-    if (!_attributeMap.count(attrib))
+    const string* standardName = findStandardAttributeName(attrib);
+    AttributeVec::iterator it = findAttributeInRange(_attributes.begin(), _attributes.end(), attrib, standardName);
+    if (it != _attributes.end())
     {
-        _attributeOrder.push_back(attrib);
+        it->second = value;
     }
-    _attributeMap[attrib] = value;
+    else
+    {
+        _attributes.emplace_back(AttributeName(attrib, standardName), value);
+    }
+
+    doc->onAttributeChange(getSelf(), attrib, false);
 }
 
 void Element::removeAttribute(const string& attrib)
 {
-    StringMap::iterator it = _attributeMap.find(attrib);
-    if (it != _attributeMap.end())
+    AttributeVec::iterator it = findAttribute(attrib);
+    if (it != _attributes.end())
     {
-        getDocument()->invalidateCache();
+        DocumentPtr doc = getMutableDocument();
+        doc->onAttributeChange(getSelf(), attrib, true);
 
-        _attributeMap.erase(it);
-        _attributeOrder.erase(
-            std::find(_attributeOrder.begin(), _attributeOrder.end(), attrib));
+        _attributes.erase(it);
+
+        doc->onAttributeChange(getSelf(), attrib, false);
     }
 }
 
@@ -309,6 +649,22 @@ ConstDocumentPtr Element::getDocument() const
     return getRoot()->asA<Document>();
 }
 
+ConstElementPtr Element::getRootDataLibrary() const
+{
+    ConstDocumentPtr doc = getDocument();
+    return doc ? doc->getDataLibrary() : nullptr;
+}
+
+DocumentPtr Element::getMutableDocument()
+{
+    DocumentPtr doc = getDocument();
+    if (doc->isFrozen())
+    {
+        throw ExceptionFrozenDocument("Requested modification of frozen document: " + asString());
+    }
+    return doc;
+}
+
 bool Element::hasInheritedBase(ConstElementPtr base) const
 {
     for (ConstElementPtr elem : traverseInheritance())
@@ -339,6 +695,11 @@ TreeIterator Element::traverseTree() const
     return TreeIterator(getSelfNonConst());
 }
 
+RawTreeIterator Element::traverseTreeRaw() const
+{
+    return RawTreeIterator(const_cast<Element*>(this));
+}
+
 GraphIterator Element::traverseGraph() const
 {
     return GraphIterator(getSelfNonConst());
@@ -361,11 +722,13 @@ InheritanceIterator Element::traverseInheritance() const
 
 void Element::copyContentFrom(const ConstElementPtr& source)
 {
-    getDocument()->invalidateCache();
+    DocumentPtr doc = getMutableDocument();
+    doc->onAttributeChange(getSelf(), EMPTY_STRING, true);
 
     _sourceUri = source->_sourceUri;
-    _attributeMap = source->_attributeMap;
-    _attributeOrder = source->_attributeOrder;
+    _attributes = source->_attributes;
+
+    doc->onAttributeChange(getSelf(), EMPTY_STRING, false);
 
     for (auto child : source->getChildren())
     {
@@ -386,13 +749,25 @@ void Element::copyContentFrom(const ConstElementPtr& source)
 
 void Element::clearContent()
 {
-    getDocument()->invalidateCache();
+    DocumentPtr doc = getMutableDocument();
+    for (ElementPtr child : _childOrder)
+    {
+        doc->onRemoveElement(child, true);
+    }
+    doc->onAttributeChange(getSelf(), EMPTY_STRING, true);
 
+    vector<ElementPtr> removedChildren;
+    removedChildren.swap(_childOrder);
     _sourceUri.clear();
-    _attributeMap.clear();
-    _attributeOrder.clear();
+    _attributes.clear();
     _childMap.clear();
-    _childOrder.clear();
+    _childNameSuffixes.clear();
+
+    for (ElementPtr child : removedChildren)
+    {
+        doc->onRemoveElement(child, false);
+    }
+    doc->onAttributeChange(getSelf(), EMPTY_STRING, false);
 }
 
 bool Element::validate(string* message) const
@@ -404,9 +779,9 @@ bool Element::validate(string* message) const
         bool validInherit = getInheritsFrom() && getInheritsFrom()->getCategory() == getCategory();
         validateRequire(validInherit, res, message, "Invalid element inheritance");
     }
-    for (auto child : getChildren())
+    for (const ElementPtr& child : getChildren())
     {
-        res = child->validate(message) && res;
+        res = validateChild(child, message) && res;
     }
     validateRequire(!hasInheritanceCycle(), res, message, "Cycle in element inheritance chain");
     return res;
@@ -449,9 +824,9 @@ string Element::asString() const
     {
         res += " name=\"" + getName() + "\"";
     }
-    for (const string& attrName : getAttributeNames())
+    for (size_t i = 0; i < getAttributeCount(); i++)
     {
-        res += " " + attrName + "=\"" + getAttribute(attrName) + "\"";
+        res += " " + getAttributeName(i) + "=\"" + getAttributeValue(i) + "\"";
     }
     res += ">";
     return res;
@@ -469,6 +844,108 @@ void Element::validateRequire(bool expression, bool& res, string* message, const
     }
 }
 
+bool Element::validateChild(const ElementPtr& child, string* message) const
+{
+    return child->validate(message);
+}
+
+uint64_t Element::getContentHash(bool excludeUiAttributes) const
+{
+    std::atomic<uint64_t>& cachedHash = excludeUiAttributes ? _uiFreeContentHash : _contentHash;
+    uint64_t hash = cachedHash.load(std::memory_order_relaxed);
+    if (hash)
+    {
+        return hash;
+    }
+
+    hash = combineHash(hashString(_category), hashString(_name));
+
+    // Attribute hashes are summed, making the result independent of the
+    // order in which attributes were set.
+    uint64_t attributeHash = 0;
+    for (const auto& attr : _attributes)
+    {
+        if (excludeUiAttributes && isUiAttribute(attr.first.str()))
+        {
+            continue;
+        }
+        attributeHash += combineHash(hashString(attr.first.str()), hashString(attr.second));
+    }
+    hash = combineHash(hash, attributeHash);
+
+    for (const ElementPtr& child : _childOrder)
+    {
+        if (excludeUiAttributes &&
+            (child->getCategory() == CommentElement::CATEGORY || child->getCategory() == NewlineElement::CATEGORY))
+        {
+            continue;
+        }
+        hash = combineHash(hash, child->getContentHash(excludeUiAttributes));
+    }
+
+    // Reserve zero to indicate a hash that has not been computed.
+    hash = hash ? hash : 1;
+    cachedHash.store(hash, std::memory_order_relaxed);
+    return hash;
+}
+
+struct Element::UpstreamHash
+{
+    size_t revision = 0;
+    uint64_t hash = 0;
+    uint64_t uiFreeHash = 0;
+};
+
+uint64_t Element::getUpstreamHash(bool excludeUiAttributes) const
+{
+    // Return a previous hash if the document has not been edited since it
+    // was computed.
+    size_t revision = getDocument()->getContentRevision();
+    shared_ptr<const UpstreamHash> cached = std::atomic_load(&_upstreamHash);
+    if (cached && cached->revision == revision)
+    {
+        uint64_t hash = excludeUiAttributes ? cached->uiFreeHash : cached->hash;
+        if (hash)
+        {
+            return hash;
+        }
+    }
+
+    uint64_t hash = getContentHash(excludeUiAttributes);
+    hash = combineInterfaceHashes(hash, getSelfNonConst(), excludeUiAttributes);
+    for (Edge edge : traverseGraph())
+    {
+        ElementPtr upstream = edge.getUpstreamElement();
+        hash = combineHash(hash, upstream->getContentHash(excludeUiAttributes));
+        hash = combineInterfaceHashes(hash, upstream, excludeUiAttributes);
+    }
+
+    // Reserve zero to indicate a hash that has not been computed, and store
+    // the result alongside any other hash for the same revision.
+    hash = hash ? hash : 1;
+    shared_ptr<UpstreamHash> newCached = std::make_shared<UpstreamHash>();
+    if (cached && cached->revision == revision)
+    {
+        *newCached = *cached;
+    }
+    newCached->revision = revision;
+    (excludeUiAttributes ? newCached->uiFreeHash : newCached->hash) = hash;
+    std::atomic_store(&_upstreamHash, shared_ptr<const UpstreamHash>(newCached));
+    return hash;
+}
+
+void Element::invalidateContentHash()
+{
+    // The hashes of all ancestors include the hash of this element.
+    _contentHash.store(0, std::memory_order_relaxed);
+    _uiFreeContentHash.store(0, std::memory_order_relaxed);
+    for (ElementPtr elem = getParent(); elem; elem = elem->getParent())
+    {
+        elem->_contentHash.store(0, std::memory_order_relaxed);
+        elem->_uiFreeContentHash.store(0, std::memory_order_relaxed);
+    }
+}
+
 //
 // TypedElement methods
 //
@@ -495,6 +972,21 @@ string ValueElement::getResolvedValueString(StringResolverPtr resolver) const
     return resolver->resolve(getValueString(), getType());
 }
 
+ValuePtr ValueElement::getValue() const
+{
+    if (!hasValue())
+    {
+        return ValuePtr();
+    }
+    ValuePtr value = std::atomic_load(&_parsedValue);
+    if (!value)
+    {
+        value = Value::createValueFromStrings(getValueString(), getType());
+        std::atomic_store(&_parsedValue, value);
+    }
+    return value;
+}
+
 ValuePtr ValueElement::getDefaultValue() const
 {
     ConstElementPtr parent = getParent();
@@ -11,10 +11,13 @@
 
 #include <MaterialXCore/Export.h>
 
+#include <MaterialXCore/Arena.h>
 #include <MaterialXCore/Traversal.h>
 #include <MaterialXCore/Util.h>
 #include <MaterialXCore/Value.h>
 
+#include <atomic>
+
 MATERIALX_NAMESPACE_BEGIN
 
 class Element;
@@ -82,6 +85,7 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     Element(ElementPtr parent, const string& category, const string& name) :
         _category(category),
         _name(name),
+        _attributes(parent ? parent->_attributes.get_allocator() : AttributeAllocator()),
         _parent(parent),
         _root(parent ? parent->getRoot() : nullptr)
     {
@@ -111,10 +115,7 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// @{
 
     /// Set the element's category string.
-    void setCategory(const string& category)
-    {
-        _category = category;
-    }
+    void setCategory(const string& category);
 
     /// Return the element's category string.  The category of a MaterialX
     /// element represents its role within the document, with common examples
@@ -496,21 +497,49 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// Return true if the given attribute is present.
     bool hasAttribute(const string& attrib) const
     {
-        return _attributeMap.count(attrib) != 0;
+        return findAttribute(attrib) != _attributes.end();
     }
 
     /// Return the value string of the given attribute.  If the given attribute
     /// is not present, then an empty string is returned.
     const string& getAttribute(const string& attrib) const
     {
-        StringMap::const_iterator it = _attributeMap.find(attrib);
-        return (it != _attributeMap.end()) ? it->second : EMPTY_STRING;
+        AttributeVec::const_iterator it = findAttribute(attrib);
+        return (it != _attributes.end()) ? it->second : EMPTY_STRING;
     }
 
     /// Return a vector of stored attribute names, in the order they were set.
-    const StringVec& getAttributeNames() const
+    /// The names are copied into the returned vector, so callers that visit
+    /// each attribute should prefer getAttributeName and getAttributeValue.
+    StringVec getAttributeNames() const
+    {
+        StringVec names;
+        names.reserve(_attributes.size());
+        for (const auto& attr : _attributes)
+        {
+            names.push_back(attr.first.str());
+        }
+        return names;
+    }
+
+    /// Return the number of stored attributes.
+    size_t getAttributeCount() const
+    {
+        return _attributes.size();
+    }
+
+    /// Return the name of the stored attribute at the given index, in the
+    /// order attributes were set.
+    const string& getAttributeName(size_t index) const
+    {
+        return _attributes.at(index).first.str();
+    }
+
+    /// Return the value string of the stored attribute at the given index,
+    /// in the order attributes were set.
+    const string& getAttributeValue(size_t index) const
     {
-        return _attributeOrder;
+        return _attributes.at(index).second;
     }
 
     /// Set the value of an implicitly typed attribute.  Since an attribute
@@ -636,6 +665,20 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// @endcode
     TreeIterator traverseTree() const;
 
+    /// Traverse the tree from the given element to each of its descendants in
+    /// depth-first order, using pre-order visitation, without updating the
+    /// reference counts of visited elements.  The traversal and the elements
+    /// it returns are valid only while the tree is not modified.
+    /// @return A RawTreeIterator object.
+    /// @details Example usage with an implicit iterator:
+    /// @code
+    /// for (Element* elem : doc->traverseTreeRaw())
+    /// {
+    ///     cout << elem->asString() << endl;
+    /// }
+    /// @endcode
+    RawTreeIterator traverseTreeRaw() const;
+
     /// Traverse the dataflow graph from the given element to each of its
     /// upstream sources in depth-first order, using pre-order visitation.
     /// @throws ExceptionFoundCycle if a cycle is encountered.
@@ -708,6 +751,7 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     ///    references.
     void setSourceUri(const string& sourceUri)
     {
+        getMutableDocument();
         _sourceUri = sourceUri;
     }
 
@@ -758,15 +802,11 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
 
     /// Using the input name as a starting point, modify it to create a valid,
     /// unique name for a child element.
-    string createValidChildName(string name) const
-    {
-        name = name.empty() ? "_" : createValidName(name);
-        while (_childMap.count(name))
-        {
-            name = incrementName(name);
-        }
-        return name;
-    }
+    ///
+    /// The result matches repeated application of incrementName, but runs in
+    /// amortized constant time when children sharing a name prefix are
+    /// created in sequence.
+    string createValidChildName(string name) const;
 
     /// Construct a StringResolver at the scope of this element.  The returned
     /// object may be used to apply substring modifiers to data values in the
@@ -783,6 +823,35 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     string asString() const;
 
     /// @}
+    /// @name Content Hashing
+    /// @{
+
+    /// Return a hash of the content of this element and its descendants,
+    /// including their categories, names, attributes and child order.  The
+    /// hash is independent of attribute order, is stable across sessions and
+    /// platforms, and is equal for any two elements that compare equal.
+    ///
+    /// Hashes are cached on each element, and edits to an element discard
+    /// only the cached hashes of that element and its ancestors.
+    /// @param excludeUiAttributes If true, then attributes that affect only
+    ///    the presentation of content (xpos, ypos, doc, uiname, uifolder and
+    ///    uiadvanced), along with comment and newline elements, are excluded
+    ///    from the hash.  Defaults to false.
+    uint64_t getContentHash(bool excludeUiAttributes = false) const;
+
+    /// Return a hash of the content of this element and of the elements in
+    /// its upstream dependency graph, as visited by traverseGraph, along with
+    /// the nodegraph interface inputs that supply their values.  The content
+    /// of definitions in data libraries is not included.
+    ///
+    /// Upstream hashes are cached on each element, and are recomputed on
+    /// the first request following any edit to the document.
+    /// @param excludeUiAttributes If true, then attributes that affect only
+    ///    the presentation of content are excluded from the hash.
+    /// @throws ExceptionFoundCycle if a cycle is encountered.
+    uint64_t getUpstreamHash(bool excludeUiAttributes = false) const;
+
+    /// @}
 
   protected:
     // Resolve a reference to a named element at the scope of the given parent,
@@ -792,13 +861,40 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     {
         ConstElementPtr scope = parent ? parent : getRoot();
         shared_ptr<T> child = scope->getChildOfType<T>(getQualifiedName(name));
-        return child ? child : scope->getChildOfType<T>(name);
+        if (!child)
+        {
+            child = scope->getChildOfType<T>(name);
+        }
+
+        // References at document scope fall through to the data library.
+        if (!child && !parent)
+        {
+            ConstElementPtr library = getRootDataLibrary();
+            while (library && !child)
+            {
+                child = library->getChildOfType<T>(getQualifiedName(name));
+                if (!child)
+                {
+                    child = library->getChildOfType<T>(name);
+                }
+                library = library->getRootDataLibrary();
+            }
+        }
+        return child;
     }
 
+    // Return the data library, if any, referenced by the root document of
+    // our tree.
+    ConstElementPtr getRootDataLibrary() const;
+
     // Enforce a requirement within a validate method, updating the validation
     // state and optional output text if the requirement is not met.
     void validateRequire(bool expression, bool& res, string* message, const string& errorDesc) const;
 
+    // Validate the given child of this element, as part of the validation
+    // of this element.
+    virtual bool validateChild(const ElementPtr& child, string* message) const;
+
   public:
     static const string NAME_ATTRIBUTE;
     static const string FILE_PREFIX_ATTRIBUTE;
@@ -814,6 +910,10 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     virtual void registerChildElement(ElementPtr child);
     virtual void unregisterChildElement(ElementPtr child);
 
+    // Return the root document of our tree, throwing an exception if the
+    // document has been frozen.
+    DocumentPtr getMutableDocument();
+
     // Return a non-const copy of our self pointer, for use in constructing
     // graph traversal objects that require non-const storage.
     ElementPtr getSelfNonConst() const
@@ -821,6 +921,74 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
         return std::const_pointer_cast<Element>(shared_from_this());
     }
 
+  protected:
+    // The name of an attribute.  The standard attribute names of MaterialX
+    // are held as handles to their shared attribute constants, allowing them
+    // to be compared by address, while any other name is stored inline.
+    class AttributeName
+    {
+      public:
+        AttributeName(const string& name, const string* standardName) :
+            _standardName(standardName),
+            _customName(standardName ? string() : name)
+        {
+        }
+
+        // Standard names are compared by handle, and never match custom names.
+        bool operator==(const AttributeName& rhs) const
+        {
+            return _standardName == rhs._standardName && _customName == rhs._customName;
+        }
+        bool operator!=(const AttributeName& rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+        const string& str() const
+        {
+            return _standardName ? *_standardName : _customName;
+        }
+
+        const string* getStandardName() const
+        {
+            return _standardName;
+        }
+
+      private:
+        const string* _standardName;
+        string _customName;
+    };
+
+    // Attributes are stored as a flat vector of name and value pairs, in the
+    // order they were set.  Since most elements hold only a handful of
+    // attributes, a linear search outperforms a hashed lookup.  Attribute
+    // storage is drawn from the memory arena of the parent element, if any.
+    using AttributeAllocator = ArenaAllocator<std::pair<AttributeName, string>>;
+    using AttributeVec = vector<std::pair<AttributeName, string>, AttributeAllocator>;
+
+    // Return the stored attribute with the given name.  Standard names are
+    // stored through their handles, so lookups through attribute constants
+    // match by address, while other lookups fall back to comparing names.
+    AttributeVec::const_iterator findAttribute(const string& attrib) const
+    {
+        AttributeVec::const_iterator it = _attributes.begin();
+        while (it != _attributes.end() && it->first.getStandardName() != &attrib && it->first.str() != attrib)
+        {
+            ++it;
+        }
+        return it;
+    }
+
+    AttributeVec::iterator findAttribute(const string& attrib)
+    {
+        AttributeVec::iterator it = _attributes.begin();
+        while (it != _attributes.end() && it->first.getStandardName() != &attrib && it->first.str() != attrib)
+        {
+            ++it;
+        }
+        return it;
+    }
+
   protected:
     string _category;
     string _name;
@@ -829,18 +997,53 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     ElementMap _childMap;
     vector<ElementPtr> _childOrder;
 
-    StringMap _attributeMap;
-    StringVec _attributeOrder;
+    AttributeVec _attributes;
 
     weak_ptr<Element> _parent;
     weak_ptr<Element> _root;
 
   private:
-    template <class T> static ElementPtr createElement(ElementPtr parent, const string& name)
+    friend class Document;
+
+    // Discard the cached content hashes of this element and its ancestors.
+    void invalidateContentHash();
+
+    // Update the ranges of taken name suffixes as a child name is added
+    // or removed.
+    void addChildNameSuffix(const string& name);
+    void removeChildNameSuffix(const string& name);
+
+    // For each name prefix, a range [first, last) of numeric suffixes for
+    // which a child named with the prefix and suffix is known to exist.
+    std::unordered_map<string, std::pair<int, int>> _childNameSuffixes;
+
+    // Cached content hashes with and without presentation attributes, where
+    // zero indicates that a hash has not been computed.
+    mutable std::atomic<uint64_t> _contentHash{ 0 };
+    mutable std::atomic<uint64_t> _uiFreeContentHash{ 0 };
+
+    // Cached upstream hashes for a single content revision of the document.
+    struct UpstreamHash;
+    mutable shared_ptr<const UpstreamHash> _upstreamHash;
+
+  private:
+    // Allocate a new element with the given parent, drawing its storage
+    // from the memory arena of the parent, if any.
+    template <class T> static shared_ptr<T> allocateElement(const ElementPtr& parent, const string& name)
     {
+        MemoryArena* arena = parent ? parent->_attributes.get_allocator().getArena() : nullptr;
+        if (arena)
+        {
+            return std::allocate_shared<T>(SharedArenaAllocator<T>(arena->shared_from_this()), parent, name);
+        }
         return std::make_shared<T>(parent, name);
     }
 
+    template <class T> static ElementPtr createElement(ElementPtr parent, const string& name)
+    {
+        return allocateElement<T>(parent, name);
+    }
+
   private:
     using CreatorFunction = ElementPtr (*)(ElementPtr, const string&);
     using CreatorMap = std::unordered_map<string, CreatorFunction>;
@@ -1023,13 +1226,37 @@ class MX_CORE_API ValueElement : public TypedElement
     /// Return the typed value of an element as a generic value object, which
     /// may be queried to access its data.
     ///
+    /// The parsed value is cached on the element until its value or type
+    /// changes, so the returned object is shared between callers and should
+    /// not be modified; use Value::copy to obtain an independent value.
+    ///
     /// @return A shared pointer to the typed value of this element, or an
     ///    empty shared pointer if no value is present.
-    ValuePtr getValue() const
+    ValuePtr getValue() const;
+
+    /// Return the typed value of an element as the given data type, without
+    /// allocating a generic value object.  If the element has no value, or
+    /// its value cannot be converted to the given data type, then the zero
+    /// value for the data type is returned.
+    template <class T> T getValueAs() const
     {
-        if (!hasValue())
-            return ValuePtr();
-        return Value::createValueFromStrings(getValueString(), getType());
+        ValuePtr value = std::atomic_load(&_parsedValue);
+        if (!value && hasValue() && getType() == getTypeString<T>())
+        {
+            try
+            {
+                return fromValueString<T>(getValueString());
+            }
+            catch (ExceptionTypeError&)
+            {
+                return {};
+            }
+        }
+        if (!value)
+        {
+            value = getValue();
+        }
+        return (value && value->isA<T>()) ? value->asA<T>() : T{};
     }
 
     /// Return the resolved value of an element as a generic value object, which
@@ -1142,6 +1369,13 @@ class MX_CORE_API ValueElement : public TypedElement
     static const string UNIT_ATTRIBUTE;
     static const string UNITTYPE_ATTRIBUTE;
     static const string UNIFORM_ATTRIBUTE;
+
+  private:
+    friend class Document;
+
+    // The parsed value of this element, which is computed on first use and
+    // cleared by the document when the value or type attribute changes.
+    mutable ValuePtr _parsedValue;
 };
 
 /// @class Token
@@ -1345,6 +1579,15 @@ class MX_CORE_API ExceptionOrphanedElement : public Exception
     using Exception::Exception;
 };
 
+/// @class ExceptionFrozenDocument
+/// An exception that is thrown when an attempt is made to modify the
+/// contents of a frozen Document.
+class MX_CORE_API ExceptionFrozenDocument : public Exception
+{
+  public:
+    using Exception::Exception;
+};
+
 template <class T> shared_ptr<T> Element::addChild(const string& name)
 {
     string childName = name;
@@ -1356,7 +1599,7 @@ template <class T> shared_ptr<T> Element::addChild(const string& name)
     if (_childMap.count(childName))
         throw Exception("Child name is not unique: " + childName);
 
-    shared_ptr<T> child = std::make_shared<T>(getSelf(), childName);
+    shared_ptr<T> child = allocateElement<T>(getSelf(), childName);
     registerChildElement(child);
 
     return child;
@@ -7,6 +7,8 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <string_view>
+
 MATERIALX_NAMESPACE_BEGIN
 
 const string GEOM_PATH_SEPARATOR = "/";
@@ -138,44 +140,140 @@ bool Collection::hasIncludeCycle() const
 
 bool Collection::matchesGeomString(const string& geom) const
 {
-    if (geomStringsMatch(getActiveExcludeGeom(), geom, true))
-    {
-        return false;
-    }
-    if (geomStringsMatch(getActiveIncludeGeom(), geom))
+    return GeomMatcher(getSelf()->asA<Collection>()).matchesGeomString(geom);
+}
+
+bool Collection::validate(string* message) const
+{
+    bool res = true;
+    validateRequire(!hasIncludeCycle(), res, message, "Cycle in collection include chain");
+    return Element::validate(message) && res;
+}
+
+//
+// GeomMatcher methods
+//
+
+GeomMatcher::GeomMatcher(const string& geom, bool contains) :
+    _contains(contains)
+{
+    _exclude = addGeomString(EMPTY_STRING);
+    _rules.push_back({ addGeomString(geom), _exclude });
+}
+
+GeomMatcher::GeomMatcher(ConstCollectionPtr collection)
+{
+    // The exclude geometry of the given collection applies to all included
+    // collections, while the exclude geometry of each included collection
+    // applies only to its own include geometry.
+    _exclude = addGeomString(collection->getActiveExcludeGeom());
+    auto addRule = [this](ConstCollectionPtr included)
     {
-        return true;
-    }
+        if (included->hasIncludeGeom())
+        {
+            _rules.push_back({ addGeomString(included->getActiveIncludeGeom()),
+                               addGeomString(included->getActiveExcludeGeom()) });
+        }
+    };
+    addRule(collection);
 
+    // Flatten the include chain of the collection.
     std::set<CollectionPtr> includedSet;
-    vector<CollectionPtr> includedVec = getIncludeCollections();
+    vector<CollectionPtr> includedVec = collection->getIncludeCollections();
     for (size_t i = 0; i < includedVec.size(); i++)
     {
-        CollectionPtr collection = includedVec[i];
-        if (includedSet.count(collection))
+        CollectionPtr included = includedVec[i];
+        if (includedSet.count(included))
         {
-            throw ExceptionFoundCycle("Encountered a cycle in collection: " + getName());
+            throw ExceptionFoundCycle("Encountered a cycle in collection: " + collection->getName());
         }
-        includedSet.insert(collection);
-        vector<CollectionPtr> appendVec = collection->getIncludeCollections();
+        includedSet.insert(included);
+        addRule(included);
+        vector<CollectionPtr> appendVec = included->getIncludeCollections();
         includedVec.insert(includedVec.end(), appendVec.begin(), appendVec.end());
     }
-    for (ConstCollectionPtr collection : includedSet)
+}
+
+bool GeomMatcher::matchesGeomString(const string& geom) const
+{
+    if (_rules.empty() || matchesRoot(_exclude, geom, true))
+    {
+        return false;
+    }
+    for (const Rule& rule : _rules)
     {
-        if (collection->matchesGeomString(geom))
+        if (matchesRoot(rule.include, geom, _contains) && !matchesRoot(rule.exclude, geom, true))
         {
             return true;
         }
     }
-
     return false;
 }
 
-bool Collection::validate(string* message) const
+size_t GeomMatcher::addGeomString(const string& geom)
 {
-    bool res = true;
-    validateRequire(!hasIncludeCycle(), res, message, "Cycle in collection include chain");
-    return Element::validate(message) && res;
+    size_t root = _tree.addRoot();
+    _tree.addGeomString(root, geom, 0);
+    return root;
+}
+
+bool GeomMatcher::matchesRoot(size_t root, const string& geom, bool contains) const
+{
+    // Descend along the path of each name, which matches any stored path
+    // that contains it.  A name that ends within the tree is contained by
+    // the stored paths beneath it.
+    return _tree.visitGeomString(root, geom, [contains](const GeomPathTree::Node& node, bool end)
+    {
+        return !node.values.empty() || (end && !contains && !node.children.empty());
+    });
+}
+
+//
+// GeomPathTree methods
+//
+
+size_t GeomPathTree::addRoot()
+{
+    _nodes.emplace_back();
+    return _nodes.size() - 1;
+}
+
+void GeomPathTree::addGeomString(size_t root, const string& geom, size_t value)
+{
+    std::string_view name;
+    for (size_t namePos = 0; getNextToken(geom, ARRAY_VALID_SEPARATORS, namePos, name);)
+    {
+        size_t node = root;
+        std::string_view component;
+        for (size_t pos = 0; getNextToken(name, GEOM_PATH_SEPARATOR, pos, component);)
+        {
+            auto it = _nodes[node].children.find(component);
+            if (it != _nodes[node].children.end())
+            {
+                node = it->second;
+                continue;
+            }
+            size_t child = _nodes.size();
+            _nodes[node].children.emplace(string(component), child);
+            _nodes.emplace_back();
+            node = child;
+        }
+        _nodes[node].values.push_back(value);
+    }
+}
+
+bool GeomPathTree::getNextToken(std::string_view str, std::string_view separators, size_t& pos, std::string_view& token)
+{
+    size_t begin = str.find_first_not_of(separators, pos);
+    if (begin == string::npos)
+    {
+        pos = str.size();
+        return false;
+    }
+    size_t end = std::min(str.find_first_of(separators, begin), str.size());
+    token = str.substr(begin, end - begin);
+    pos = end;
+    return true;
 }
 
 MATERIALX_NAMESPACE_END
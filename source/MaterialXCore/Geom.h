@@ -13,6 +13,9 @@
 
 #include <MaterialXCore/Element.h>
 
+#include <map>
+#include <string_view>
+
 MATERIALX_NAMESPACE_BEGIN
 
 extern MX_CORE_API const string GEOM_PATH_SEPARATOR;
@@ -565,6 +568,125 @@ class MX_CORE_API Collection : public Element
     static const string INCLUDE_COLLECTION_ATTRIBUTE;
 };
 
+/// @class GeomPathTree
+/// A prefix tree of geometry paths, indexing the nodes at the end of each
+/// stored path by the values with which they were added.
+///
+/// A tree may hold any number of roots, each of which stores the paths of
+/// one or more geometry strings.
+class MX_CORE_API GeomPathTree
+{
+  public:
+    /// A node of the tree, indexing its children by path component.
+    struct Node
+    {
+        std::map<string, size_t, std::less<>> children;
+        vector<size_t> values;
+    };
+
+  public:
+    GeomPathTree() { }
+    ~GeomPathTree() { }
+
+    /// Add a new root to the tree, returning its index.
+    size_t addRoot();
+
+    /// Add each path of the given geometry string beneath the given root,
+    /// appending the given value to the node at the end of each path.
+    void addGeomString(size_t root, const string& geom, size_t value);
+
+    /// For each path of the given geometry string, descend from the given
+    /// root along the stored nodes that match the path, calling the given
+    /// visitor with each node along the way, and with a flag that is true
+    /// if the node is at the end of the path.  Returns true as soon as the
+    /// visitor returns true, and false otherwise.
+    template <class Visitor> bool visitGeomString(size_t root, const string& geom, Visitor visitor) const;
+
+  private:
+    static bool getNextToken(std::string_view str, std::string_view separators, size_t& pos, std::string_view& token);
+
+  private:
+    vector<Node> _nodes;
+};
+
+/// @class GeomMatcher
+/// A precompiled matcher for geometry strings, answering repeated queries
+/// against a fixed geometry string or collection.
+///
+/// The geometry paths of the matcher are stored in a prefix tree, and the
+/// include chain of a collection is flattened when the matcher is
+/// constructed, so each query runs in time proportional to the depth of the
+/// queried paths, for each collection in the include chain that specifies
+/// geometry.  A matcher holds no references to the elements from which it
+/// was constructed, and must be reconstructed if they are edited.
+class MX_CORE_API GeomMatcher
+{
+  public:
+    /// Construct a matcher that matches no geometries.
+    GeomMatcher() { }
+
+    /// Construct a matcher for the given geometry string, whose queries
+    /// return the result of geomStringsMatch(geom, query, contains).
+    explicit GeomMatcher(const string& geom, bool contains = false);
+
+    /// Construct a matcher for the given collection, whose queries return
+    /// the result of collection->matchesGeomString(query).
+    /// @throws ExceptionFoundCycle if a cycle is encountered.
+    explicit GeomMatcher(ConstCollectionPtr collection);
+
+    ~GeomMatcher() { }
+
+    /// Return true if the given geometry string matches this matcher.
+    bool matchesGeomString(const string& geom) const;
+
+  private:
+    // A set of included paths, together with the set of paths that are
+    // excluded from them.
+    struct Rule
+    {
+        size_t include;
+        size_t exclude;
+    };
+
+    size_t addGeomString(const string& geom);
+    bool matchesRoot(size_t root, const string& geom, bool contains) const;
+
+  private:
+    GeomPathTree _tree;
+    vector<Rule> _rules;
+    size_t _exclude = 0;
+    bool _contains = false;
+};
+
+template <class Visitor> bool GeomPathTree::visitGeomString(size_t root, const string& geom, Visitor visitor) const
+{
+    std::string_view name;
+    for (size_t namePos = 0; getNextToken(geom, ARRAY_VALID_SEPARATORS, namePos, name);)
+    {
+        size_t node = root;
+        std::string_view component;
+        for (size_t pos = 0;;)
+        {
+            bool end = !getNextToken(name, GEOM_PATH_SEPARATOR, pos, component);
+            if (visitor(_nodes[node], end))
+            {
+                return true;
+            }
+            if (end)
+            {
+                break;
+            }
+            auto it = _nodes[node].children.find(component);
+            if (it == _nodes[node].children.end())
+            {
+                break;
+            }
+            node = it->second;
+        }
+    }
+    return false;
+}
+
 template <class T> GeomPropPtr GeomInfo::setGeomPropValue(const string& name,
                                                           const T& value,
                                                           const string& type)
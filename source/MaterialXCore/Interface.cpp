@@ -356,64 +356,24 @@ bool Output::validate(string* message) const
 
 InputPtr InterfaceElement::getActiveInput(const string& name) const
 {
-    for (ConstElementPtr elem : traverseInheritance())
-    {
-        InputPtr input = elem->asA<InterfaceElement>()->getInput(name);
-        if (input)
-        {
-            return input;
-        }
-    }
-    return nullptr;
+    ConstActiveInterfacePtr active = getActiveInterface();
+    return ActiveInterface::findElement(active->inputs, active->inputIndices, name);
 }
 
 vector<InputPtr> InterfaceElement::getActiveInputs() const
 {
-    vector<InputPtr> activeInputs;
-    StringSet activeInputNamesSet;
-    for (ConstElementPtr elem : traverseInheritance())
-    {
-        vector<InputPtr> inputs = elem->asA<InterfaceElement>()->getInputs();
-        for (const InputPtr& input : inputs)
-        {
-            if (input && activeInputNamesSet.insert(input->getName()).second)
-            {
-                activeInputs.push_back(input);
-            }
-        }
-    }
-    return activeInputs;
+    return getActiveInterface()->inputs;
 }
 
 OutputPtr InterfaceElement::getActiveOutput(const string& name) const
 {
-    for (ConstElementPtr elem : traverseInheritance())
-    {
-        OutputPtr output = elem->asA<InterfaceElement>()->getOutput(name);
-        if (output)
-        {
-            return output;
-        }
-    }
-    return nullptr;
+    ConstActiveInterfacePtr active = getActiveInterface();
+    return ActiveInterface::findElement(active->outputs, active->outputIndices, name);
 }
 
 vector<OutputPtr> InterfaceElement::getActiveOutputs() const
 {
-    vector<OutputPtr> activeOutputs;
-    StringSet activeOutputNamesSet;
-    for (ConstElementPtr elem : traverseInheritance())
-    {
-        vector<OutputPtr> outputs = elem->asA<InterfaceElement>()->getOutputs();
-        for (const OutputPtr& output : outputs)
-        {
-            if (output && activeOutputNamesSet.insert(output->getName()).second)
-            {
-                activeOutputs.push_back(output);
-            }
-        }
-    }
-    return activeOutputs;
+    return getActiveInterface()->outputs;
 }
 
 void InterfaceElement::setConnectedOutput(const string& inputName, OutputPtr output)
@@ -442,57 +402,24 @@ OutputPtr InterfaceElement::getConnectedOutput(const string& inputName) const
 
 TokenPtr InterfaceElement::getActiveToken(const string& name) const
 {
-    for (ConstElementPtr elem : traverseInheritance())
-    {
-        TokenPtr token = elem->asA<InterfaceElement>()->getToken(name);
-        if (token)
-        {
-            return token;
-        }
-    }
-    return nullptr;
+    ConstActiveInterfacePtr active = getActiveInterface();
+    return ActiveInterface::findElement(active->tokens, active->tokenIndices, name);
 }
 
 vector<TokenPtr> InterfaceElement::getActiveTokens() const
 {
-    vector<TokenPtr> activeTokens;
-    for (ConstElementPtr elem : traverseInheritance())
-    {
-        vector<TokenPtr> tokens = elem->asA<InterfaceElement>()->getTokens();
-        activeTokens.insert(activeTokens.end(), tokens.begin(), tokens.end());
-    }
-    return activeTokens;
+    return getActiveInterface()->tokens;
 }
 
 ValueElementPtr InterfaceElement::getActiveValueElement(const string& name) const
 {
-    for (ConstElementPtr interface : traverseInheritance())
-    {
-        ValueElementPtr valueElem = interface->getChildOfType<ValueElement>(name);
-        if (valueElem)
-        {
-            return valueElem;
-        }
-    }
-    return nullptr;
+    ConstActiveInterfacePtr active = getActiveInterface();
+    return ActiveInterface::findElement(active->valueElements, active->valueElementIndices, name);
 }
 
 vector<ValueElementPtr> InterfaceElement::getActiveValueElements() const
 {
-    vector<ValueElementPtr> activeValueElems;
-    StringSet activeValueElemNamesSet;
-    for (ConstElementPtr interface : traverseInheritance())
-    {
-        vector<ValueElementPtr> valueElems = interface->getChildrenOfType<ValueElement>();
-        for (const ValueElementPtr& valueElem : valueElems)
-        {
-            if (valueElem && activeValueElemNamesSet.insert(valueElem->getName()).second)
-            {
-                activeValueElems.push_back(valueElem);
-            }
-        }
-    }
-    return activeValueElems;
+    return getActiveInterface()->valueElements;
 }
 
 ValuePtr InterfaceElement::getInputValue(const string& name, const string& target) const
@@ -550,7 +477,8 @@ std::pair<int, int> InterfaceElement::getVersionIntegers() const
 
 void InterfaceElement::registerChildElement(ElementPtr child)
 {
-    TypedElement::registerChildElement(child);
+    // Counts are updated first, as the document notifies observers of the
+    // edit before returning.
     if (child->isA<Input>())
     {
         _inputCount++;
@@ -559,11 +487,11 @@ void InterfaceElement::registerChildElement(ElementPtr child)
     {
         _outputCount++;
     }
+    TypedElement::registerChildElement(child);
 }
 
 void InterfaceElement::unregisterChildElement(ElementPtr child)
 {
-    TypedElement::unregisterChildElement(child);
     if (child->isA<Input>())
     {
         _inputCount--;
@@ -572,6 +500,7 @@ void InterfaceElement::unregisterChildElement(ElementPtr child)
     {
         _outputCount--;
     }
+    TypedElement::unregisterChildElement(child);
 }
 
 ConstInterfaceElementPtr InterfaceElement::getDeclaration(const string&) const
@@ -579,6 +508,54 @@ ConstInterfaceElementPtr InterfaceElement::getDeclaration(const string&) const
     return InterfaceElementPtr();
 }
 
+InterfaceElement::ConstActiveInterfacePtr InterfaceElement::getActiveInterface() const
+{
+    // Active interfaces are cached only for elements within a document,
+    // and remain valid until the structure of the document changes.
+    ElementPtr root = _root.lock();
+    ConstDocumentPtr doc = root ? root->asA<Document>() : nullptr;
+    size_t revision = doc ? doc->getStructureRevision() : 0;
+    ConstActiveInterfacePtr active = std::atomic_load(&_activeInterface);
+    if (doc && active && active->revision == revision)
+    {
+        return active;
+    }
+
+    // Flatten the inheritance chain of this interface.
+    shared_ptr<ActiveInterface> newActive = std::make_shared<ActiveInterface>(revision);
+    for (ConstElementPtr interface : traverseInheritance())
+    {
+        for (const ElementPtr& child : interface->getChildren())
+        {
+            ValueElementPtr valueElem = child->asA<ValueElement>();
+            if (!valueElem)
+            {
+                continue;
+            }
+            ActiveInterface::addElement(newActive->valueElements, newActive->valueElementIndices, valueElem);
+            if (InputPtr input = child->asA<Input>())
+            {
+                ActiveInterface::addElement(newActive->inputs, newActive->inputIndices, input);
+            }
+            else if (OutputPtr output = child->asA<Output>())
+            {
+                ActiveInterface::addElement(newActive->outputs, newActive->outputIndices, output);
+            }
+            else if (TokenPtr token = child->asA<Token>())
+            {
+                ActiveInterface::addElement(newActive->tokens, newActive->tokenIndices, token, true);
+            }
+        }
+    }
+
+    active = newActive;
+    if (doc)
+    {
+        std::atomic_store(&_activeInterface, active);
+    }
+    return active;
+}
+
 void InterfaceElement::clearContent()
 {
     _inputCount = 0;
@@ -588,9 +565,11 @@ void InterfaceElement::clearContent()
 
 bool InterfaceElement::hasExactInputMatch(ConstInterfaceElementPtr declaration, string* message) const
 {
-    for (InputPtr input : getActiveInputs())
+    ConstActiveInterfacePtr active = getActiveInterface();
+    ConstActiveInterfacePtr declarationActive = declaration->getActiveInterface();
+    for (const InputPtr& input : active->inputs)
     {
-        InputPtr declarationInput = declaration->getActiveInput(input->getName());
+        InputPtr declarationInput = ActiveInterface::findElement(declarationActive->inputs, declarationActive->inputIndices, input->getName());
         if (!declarationInput ||
             declarationInput->getType() != input->getType())
         {
@@ -656,9 +656,61 @@ class MX_CORE_API InterfaceElement : public TypedElement
     void registerChildElement(ElementPtr child) override;
     void unregisterChildElement(ElementPtr child) override;
 
+  protected:
+    // A flattened view of the active value elements of an interface, taking
+    // inheritance into account.
+    class ActiveInterface
+    {
+      public:
+        explicit ActiveInterface(size_t rev) :
+            revision(rev)
+        {
+        }
+
+        // Append the given element to the given vector, recording its index by
+        // name.  Unless duplicates are allowed, elements whose names have
+        // already been recorded are skipped.
+        template <class T> static void addElement(vector<shared_ptr<T>>& elems, std::unordered_map<string, size_t>& indices,
+                                                  const shared_ptr<T>& elem, bool allowDuplicates = false)
+        {
+            if (indices.emplace(elem->getName(), elems.size()).second || allowDuplicates)
+            {
+                elems.push_back(elem);
+            }
+        }
+
+        // Return the element with the given name, if any.
+        template <class T> static shared_ptr<T> findElement(const vector<shared_ptr<T>>& elems, const std::unordered_map<string, size_t>& indices,
+                                                            const string& name)
+        {
+            auto it = indices.find(name);
+            return (it != indices.end()) ? elems[it->second] : nullptr;
+        }
+
+      public:
+        const size_t revision;
+
+        vector<InputPtr> inputs;
+        vector<OutputPtr> outputs;
+        vector<TokenPtr> tokens;
+        vector<ValueElementPtr> valueElements;
+
+        std::unordered_map<string, size_t> inputIndices;
+        std::unordered_map<string, size_t> outputIndices;
+        std::unordered_map<string, size_t> tokenIndices;
+        std::unordered_map<string, size_t> valueElementIndices;
+    };
+
+    using ConstActiveInterfacePtr = shared_ptr<const ActiveInterface>;
+
+    // Return the active interface of this element, which is computed on
+    // first use and recomputed after structural changes to the document.
+    ConstActiveInterfacePtr getActiveInterface() const;
+
   private:
     size_t _inputCount;
     size_t _outputCount;
+    mutable ConstActiveInterfacePtr _activeInterface;
 };
 
 template <class T> InputPtr InterfaceElement::setInputValue(const string& name,
@@ -7,6 +7,10 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 MATERIALX_NAMESPACE_BEGIN
 
 const string MaterialAssign::MATERIAL_ATTRIBUTE = "material";
@@ -20,6 +24,13 @@ const string Visibility::VISIBLE_ATTRIBUTE = "visible";
 const string LookGroup::LOOKS_ATTRIBUTE = "looks";
 const string LookGroup::ACTIVE_ATTRIBUTE = "active";
 
+namespace
+{
+
+const size_t RESOLVE_BATCH_SIZE = 256;
+
+} // anonymous namespace
+
 vector<MaterialAssignPtr> getGeometryBindings(ConstNodePtr materialNode, const string& geom)
 {
     vector<MaterialAssignPtr> matAssigns;
@@ -115,6 +126,176 @@ vector<VisibilityPtr> Look::getActiveVisibilities() const
     return activeVisibilities;
 }
 
+//
+// LookResolver methods
+//
+
+LookResolver::LookResolver(ConstLookPtr look)
+{
+    _tree.addRoot();
+    addLook(look);
+}
+
+LookResolver::LookResolver(ConstLookGroupPtr lookGroup)
+{
+    _tree.addRoot();
+    const string& activeLook = lookGroup->getActiveLook();
+    StringVec lookNames = activeLook.empty() ? splitString(lookGroup->getLooks(), ARRAY_VALID_SEPARATORS) : StringVec{ activeLook };
+    for (const string& lookName : lookNames)
+    {
+        LookPtr look = lookGroup->getDocument()->getLook(lookName);
+        if (look)
+        {
+            addLook(look);
+        }
+    }
+}
+
+GeomAssignments LookResolver::resolve(const string& geom) const
+{
+    GeomAssignments result;
+    vector<size_t> matches;
+    resolveGeom(geom, matches, result);
+    return result;
+}
+
+vector<GeomAssignments> LookResolver::resolve(const StringVec& geoms, unsigned int threadCount) const
+{
+    // Resolve batches of geometry, with each thread claiming the next batch.
+    vector<GeomAssignments> results(geoms.size());
+    size_t batchCount = (geoms.size() + RESOLVE_BATCH_SIZE - 1) / RESOLVE_BATCH_SIZE;
+    if (!threadCount)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threadCount = (unsigned int) std::min<size_t>(threadCount, batchCount);
+    std::atomic<size_t> nextBatch(0);
+    auto resolveBatches = [&]()
+    {
+        vector<size_t> matches;
+        for (size_t batch = nextBatch++; batch < batchCount; batch = nextBatch++)
+        {
+            size_t end = std::min((batch + 1) * RESOLVE_BATCH_SIZE, geoms.size());
+            for (size_t i = batch * RESOLVE_BATCH_SIZE; i < end; i++)
+            {
+                resolveGeom(geoms[i], matches, results[i]);
+            }
+        }
+    };
+    vector<std::thread> threads;
+    for (unsigned int i = 1; i < threadCount; i++)
+    {
+        threads.emplace_back(resolveBatches);
+    }
+    resolveBatches();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    return results;
+}
+
+void LookResolver::addLook(ConstLookPtr look)
+{
+    for (MaterialAssignPtr matAssign : look->getActiveMaterialAssigns())
+    {
+        addEntry(EntryMaterialAssign, _materialAssigns.size(), matAssign->getActiveGeom(), matAssign->getCollection());
+        _materialAssigns.push_back(matAssign);
+        _materialVariantAssigns.push_back(matAssign->getActiveVariantAssigns());
+    }
+    for (PropertyAssignPtr propAssign : look->getActivePropertyAssigns())
+    {
+        const string geom = propAssign->hasGeom() ?
+                            propAssign->createStringResolver()->resolve(propAssign->getGeom(), GEOMNAME_TYPE_STRING) :
+                            EMPTY_STRING;
+        addEntry(EntryPropertyAssign, _propertyAssigns.size(), geom, propAssign->getCollection());
+        _propertyAssigns.push_back(propAssign);
+    }
+    for (PropertySetAssignPtr propSetAssign : look->getActivePropertySetAssigns())
+    {
+        addEntry(EntryPropertySetAssign, _propertySetAssigns.size(), propSetAssign->getActiveGeom(), propSetAssign->getCollection());
+        _propertySetAssigns.push_back(propSetAssign);
+    }
+    for (VisibilityPtr visibility : look->getActiveVisibilities())
+    {
+        addEntry(EntryVisibility, _visibilities.size(), visibility->getActiveGeom(), visibility->getCollection());
+        _visibilities.push_back(visibility);
+    }
+    for (VariantAssignPtr variantAssign : look->getActiveVariantAssigns())
+    {
+        _variantAssigns.push_back(variantAssign);
+    }
+}
+
+void LookResolver::addEntry(EntryType type, size_t index, const string& geom, CollectionPtr collection)
+{
+    size_t entry = _entries.size();
+    _entries.push_back({ type, index });
+
+    // Add each path of the geometry string to the prefix tree.
+    _tree.addGeomString(0, geom, entry);
+
+    // Compile each distinct collection once.
+    if (collection)
+    {
+        auto it = _collectionIndices.find(collection->getNamePath());
+        if (it == _collectionIndices.end())
+        {
+            it = _collectionIndices.emplace(collection->getNamePath(), _collections.size()).first;
+            _collections.emplace_back(GeomMatcher(collection), vector<size_t>());
+        }
+        _collections[it->second].second.push_back(entry);
+    }
+}
+
+void LookResolver::resolveGeom(const string& geom, vector<size_t>& matches, GeomAssignments& result) const
+{
+    // Gather the entries whose geometry contains a path of the given
+    // geometry string, along with the entries of matching collections.
+    matches.clear();
+    _tree.visitGeomString(0, geom, [&matches](const GeomPathTree::Node& node, bool)
+    {
+        matches.insert(matches.end(), node.values.begin(), node.values.end());
+        return false;
+    });
+    for (const auto& collection : _collections)
+    {
+        if (collection.first.matchesGeomString(geom))
+        {
+            matches.insert(matches.end(), collection.second.begin(), collection.second.end());
+        }
+    }
+
+    // Report matching entries in the order of the active assignments.
+    std::sort(matches.begin(), matches.end());
+    matches.erase(std::unique(matches.begin(), matches.end()), matches.end());
+    result.variantAssigns = _variantAssigns;
+    for (size_t match : matches)
+    {
+        const Entry& entry = _entries[match];
+        switch (entry.type)
+        {
+            case EntryMaterialAssign:
+            {
+                const MaterialAssignPtr& matAssign = _materialAssigns[entry.index];
+                result.materialAssigns.push_back(matAssign);
+                const vector<VariantAssignPtr>& variantAssigns = _materialVariantAssigns[entry.index];
+                result.variantAssigns.insert(result.variantAssigns.end(), variantAssigns.begin(), variantAssigns.end());
+                break;
+            }
+            case EntryPropertyAssign:
+                result.propertyAssigns.push_back(_propertyAssigns[entry.index]);
+                break;
+            case EntryPropertySetAssign:
+                result.propertySetAssigns.push_back(_propertySetAssigns[entry.index]);
+                break;
+            case EntryVisibility:
+                result.visibilities.push_back(_visibilities[entry.index]);
+                break;
+        }
+    }
+}
+
 //
 // MaterialAssign methods
 //
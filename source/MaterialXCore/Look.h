@@ -22,6 +22,8 @@ class LookGroup;
 class LookInherit;
 class MaterialAssign;
 class Visibility;
+class GeomAssignments;
+class LookResolver;
 
 /// A shared pointer to a Look
 using LookPtr = shared_ptr<Look>;
@@ -488,6 +490,102 @@ class MX_CORE_API Visibility : public GeomElement
     static const string VISIBLE_ATTRIBUTE;
 };
 
+/// @class GeomAssignments
+/// The assignments of one or more looks that apply to a single geometry, as
+/// returned by a LookResolver.
+///
+/// Each vector follows the order of the active assignments of the looks, so
+/// the first material assignment is the binding of an exclusive assignment.
+class MX_CORE_API GeomAssignments
+{
+  public:
+    /// The material assignments that apply to the geometry.
+    vector<MaterialAssignPtr> materialAssigns;
+
+    /// The property assignments that apply to the geometry.
+    vector<PropertyAssignPtr> propertyAssigns;
+
+    /// The property set assignments that apply to the geometry.
+    vector<PropertySetAssignPtr> propertySetAssigns;
+
+    /// The visibility elements that apply to the geometry.
+    vector<VisibilityPtr> visibilities;
+
+    /// The variant assignments of the looks, followed by the variant
+    /// assignments of the matching material assignments.
+    vector<VariantAssignPtr> variantAssigns;
+};
+
+/// @class LookResolver
+/// A precompiled index of the active assignments of one or more looks, which
+/// resolves the assignments that apply to large batches of geometry.
+///
+/// The geometry strings of all assignments are stored in a single prefix
+/// tree, and collections are compiled to a GeomMatcher once, so resolving
+/// a geometry runs in time proportional to the depth of its path and the
+/// number of assigned collections.  A resolver must be reconstructed if its
+/// looks are edited.
+class MX_CORE_API LookResolver
+{
+  public:
+    /// Construct a resolver for the active assignments of the given look,
+    /// taking look inheritance into account.
+    /// @throws ExceptionFoundCycle if a cycle is encountered in a collection.
+    explicit LookResolver(ConstLookPtr look);
+
+    /// Construct a resolver for the active look of the given look group, or
+    /// for each of its looks in order if no active look is specified.
+    /// @throws ExceptionFoundCycle if a cycle is encountered in a collection.
+    explicit LookResolver(ConstLookGroupPtr lookGroup);
+
+    ~LookResolver() { }
+
+    /// Return the assignments that apply to the given geometry string.
+    GeomAssignments resolve(const string& geom) const;
+
+    /// Return the assignments that apply to each of the given geometry
+    /// strings, in the same order.
+    /// @param geoms The geometry strings to be resolved.
+    /// @param threadCount The number of threads that resolve geometry
+    ///    concurrently.  Defaults to zero, which selects the number of
+    ///    hardware threads.
+    vector<GeomAssignments> resolve(const StringVec& geoms, unsigned int threadCount = 0) const;
+
+  private:
+    // The kinds of assignment that are stored in the resolver.
+    enum EntryType
+    {
+        EntryMaterialAssign,
+        EntryPropertyAssign,
+        EntryPropertySetAssign,
+        EntryVisibility
+    };
+
+    // An assignment, stored as an index into the vector of its type.
+    struct Entry
+    {
+        EntryType type;
+        size_t index;
+    };
+
+    void addLook(ConstLookPtr look);
+    void addEntry(EntryType type, size_t index, const string& geom, CollectionPtr collection);
+    void resolveGeom(const string& geom, vector<size_t>& matches, GeomAssignments& result) const;
+
+  private:
+    vector<Entry> _entries;
+    GeomPathTree _tree;
+    vector<std::pair<GeomMatcher, vector<size_t>>> _collections;
+    std::unordered_map<string, size_t> _collectionIndices;
+
+    vector<MaterialAssignPtr> _materialAssigns;
+    vector<vector<VariantAssignPtr>> _materialVariantAssigns;
+    vector<PropertyAssignPtr> _propertyAssigns;
+    vector<PropertySetAssignPtr> _propertySetAssigns;
+    vector<VisibilityPtr> _visibilities;
+    vector<VariantAssignPtr> _variantAssigns;
+};
+
 /// Return a vector of all MaterialAssign elements that bind this material node
 /// to the given geometry string
 /// @param materialNode Node to examine
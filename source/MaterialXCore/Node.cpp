@@ -9,6 +9,7 @@
 #include <MaterialXCore/Material.h>
 
 #include <deque>
+#include <unordered_set>
 
 MATERIALX_NAMESPACE_BEGIN
 
@@ -16,6 +17,46 @@ const string Backdrop::CONTAINS_ATTRIBUTE = "contains";
 const string Backdrop::WIDTH_ATTRIBUTE = "width";
 const string Backdrop::HEIGHT_ATTRIBUTE = "height";
 
+//
+// Node::NodeDefResolution
+//
+
+class Node::NodeDefResolution
+{
+  public:
+    struct Result
+    {
+        string target;
+        bool allowRoughMatch;
+        NodeDefPtr nodeDef;
+    };
+
+    static const size_t MAX_RESULTS = 4;
+
+  public:
+    explicit NodeDefResolution(size_t rev) :
+        revision(rev)
+    {
+    }
+
+    // Return the stored result for the given arguments, if any.
+    const Result* find(const string& target, bool allowRoughMatch) const
+    {
+        for (const Result& result : results)
+        {
+            if (result.allowRoughMatch == allowRoughMatch && result.target == target)
+            {
+                return &result;
+            }
+        }
+        return nullptr;
+    }
+
+  public:
+    const size_t revision;
+    vector<Result> results;
+};
+
 //
 // Node methods
 //
@@ -74,33 +115,34 @@ NodeDefPtr Node::getNodeDef(const string& target, bool allowRoughMatch) const
     {
         return resolveNameReference<NodeDef>(getNodeDefString());
     }
-    vector<NodeDefPtr> nodeDefs = getDocument()->getMatchingNodeDefs(getQualifiedName(getCategory()));
-    vector<NodeDefPtr> secondary = getDocument()->getMatchingNodeDefs(getCategory());
-    vector<NodeDefPtr> roughMatches;
-    nodeDefs.insert(nodeDefs.end(), secondary.begin(), secondary.end());
-    for (NodeDefPtr nodeDef : nodeDefs)
+
+    // Return a previous resolution if the definitions of the document have
+    // not changed since it was computed.  The document discards resolutions
+    // on edits to the interface of the node, while nodes with inheritance
+    // are always resolved, as their interfaces depend on other nodes.
+    ConstDocumentPtr doc = getDocument();
+    size_t revision = doc->getDefinitionRevision();
+    shared_ptr<const NodeDefResolution> resolution = hasInheritString() ? nullptr : std::atomic_load(&_nodeDefResolution);
+    if (resolution && resolution->revision == revision)
     {
-        if (!targetStringsMatch(nodeDef->getTarget(), target) ||
-            !nodeDef->isVersionCompatible(getVersionString()) ||
-            nodeDef->getType() != getType())
-        {
-            continue;
-        }
-        if (!hasExactInputMatch(nodeDef))
+        const NodeDefResolution::Result* result = resolution->find(target, allowRoughMatch);
+        if (result)
         {
-            if (allowRoughMatch)
-            {
-                roughMatches.push_back(nodeDef);
-            }
-            continue;
+            return result->nodeDef;
         }
-        return nodeDef;
     }
-    if (!roughMatches.empty())
+
+    // Resolve the nodedef through the document index, and store the result.
+    NodeDefPtr nodeDef = doc->resolveNodeDef(*this, target, allowRoughMatch);
+    shared_ptr<NodeDefResolution> newResolution = std::make_shared<NodeDefResolution>(revision);
+    if (resolution && resolution->revision == revision)
     {
-        return roughMatches[0];
+        size_t start = resolution->results.size() >= NodeDefResolution::MAX_RESULTS ? 1 : 0;
+        newResolution->results.assign(resolution->results.begin() + start, resolution->results.end());
     }
-    return NodeDefPtr();
+    newResolution->results.push_back({ target, allowRoughMatch, nodeDef });
+    std::atomic_store(&_nodeDefResolution, shared_ptr<const NodeDefResolution>(newResolution));
+    return nodeDef;
 }
 
 Edge Node::getUpstreamEdge(size_t index) const
@@ -172,19 +214,7 @@ OutputPtr Node::getNodeDefOutput(ElementPtr connectingElement)
 
 vector<PortElementPtr> Node::getDownstreamPorts() const
 {
-    vector<PortElementPtr> downstreamPorts;
-    for (PortElementPtr port : getDocument()->getMatchingPorts(getQualifiedName(getName())))
-    {
-        if (port->getConnectedNode() == getSelf())
-        {
-            downstreamPorts.push_back(port);
-        }
-    }
-    std::sort(downstreamPorts.begin(), downstreamPorts.end(), [](const ConstElementPtr& a, const ConstElementPtr& b)
-    {
-        return a->getName() > b->getName();
-    });
-    return downstreamPorts;
+    return getDocument()->getConnectedPorts(*this);
 }
 
 bool Node::validate(string* message) const
@@ -209,6 +239,41 @@ bool Node::validate(string* message) const
     return InterfaceElement::validate(message) && res;
 }
 
+namespace
+{
+
+// The content of a graph implementation that is shared by all instances of
+// its node definition while flattening subgraphs.
+struct SubgraphImplementation
+{
+    NodeGraphPtr graph;
+    vector<NodePtr> nodes;
+    vector<vector<PortElementPtr>> downstreamPorts;
+};
+
+using FlattenedNodeMap = std::unordered_map<ElementPtr, vector<NodePtr>>;
+
+// Append the given child to a child order, recursively replacing flattened
+// nodes with their subnodes.
+void appendFlattenedChild(ElementPtr child, const FlattenedNodeMap& flattenedNodeMap,
+                          vector<ElementPtr>& childOrder, std::unordered_set<ElementPtr>& placedChildren)
+{
+    FlattenedNodeMap::const_iterator it = flattenedNodeMap.find(child);
+    if (it != flattenedNodeMap.end())
+    {
+        for (NodePtr subNode : it->second)
+        {
+            appendFlattenedChild(subNode, flattenedNodeMap, childOrder, placedChildren);
+        }
+    }
+    else if (placedChildren.insert(child).second)
+    {
+        childOrder.push_back(child);
+    }
+}
+
+} // anonymous namespace
+
 //
 // GraphElement methods
 //
@@ -228,151 +293,204 @@ NodePtr GraphElement::addMaterialNode(const string& name, ConstNodePtr shaderNod
 
 void GraphElement::flattenSubgraphs(const string& target, NodePredicate filter)
 {
-    vector<NodePtr> nodeQueue = getNodes();
+    // Graph implementations are resolved once per node definition, along
+    // with the internal connections of their nodes.
+    std::unordered_map<NodeDefPtr, std::shared_ptr<SubgraphImplementation>> implementationMap;
+
+    // The nodes that replace each flattened node, used to restore the order
+    // of children once all subgraphs have been flattened.
+    FlattenedNodeMap flattenedNodeMap;
+    const vector<ElementPtr> origChildOrder = _childOrder;
+
+    // Process nodes in the order they were added, appending the subnodes of
+    // each flattened node to the worklist to handle nested subgraphs.
+    std::deque<NodePtr> nodeQueue;
+    for (NodePtr node : getNodes())
+    {
+        nodeQueue.push_back(node);
+    }
     while (!nodeQueue.empty())
     {
-        // Determine which nodes require processing, and precompute declarations
-        // and graph implementations for these nodes.
-        using PortElementVec = vector<PortElementPtr>;
-        std::vector<NodePtr> processNodeVec;
-        std::unordered_map<NodePtr, NodeGraphPtr> graphImplMap;
-        std::unordered_map<NodePtr, ConstInterfaceElementPtr> declarationMap;
-        std::unordered_map<NodePtr, PortElementVec> downstreamPortMap;
-        for (NodePtr node : nodeQueue)
+        NodePtr processNode = nodeQueue.front();
+        nodeQueue.pop_front();
+        if (filter && !filter(processNode))
         {
-            if (filter && !filter(node))
-            {
-                continue;
-            }
+            continue;
+        }
 
-            InterfaceElementPtr implement = node->getImplementation(target);
+        NodeDefPtr nodeDef = processNode->getNodeDef(target);
+        if (!nodeDef)
+        {
+            continue;
+        }
+        auto implIt = implementationMap.find(nodeDef);
+        if (implIt == implementationMap.end())
+        {
+            std::shared_ptr<SubgraphImplementation> subgraphImpl;
+            InterfaceElementPtr implement = nodeDef->getImplementation(target);
             if (implement && implement->isA<NodeGraph>())
             {
-                processNodeVec.push_back(node);
-                graphImplMap[node] = implement->asA<NodeGraph>();
-                declarationMap[node] = node->getDeclaration(target);
-                downstreamPortMap[node] = node->getDownstreamPorts();
-                for (NodePtr sourceSubNode : implement->asA<NodeGraph>()->getNodes())
+                subgraphImpl = std::make_shared<SubgraphImplementation>();
+                subgraphImpl->graph = implement->asA<NodeGraph>();
+                subgraphImpl->nodes = subgraphImpl->graph->getNodes();
+                for (NodePtr sourceSubNode : subgraphImpl->nodes)
                 {
-                    downstreamPortMap[sourceSubNode] = sourceSubNode->getDownstreamPorts();
+                    subgraphImpl->downstreamPorts.push_back(sourceSubNode->getDownstreamPorts());
                 }
             }
+            implIt = implementationMap.emplace(nodeDef, subgraphImpl).first;
         }
-        nodeQueue.clear();
-
-        // Iterate through nodes with graph implementations.
-        for (NodePtr processNode : processNodeVec)
+        if (!implIt->second)
         {
-            NodeGraphPtr sourceSubGraph = graphImplMap[processNode];
-            std::unordered_map<NodePtr, NodePtr> subNodeMap;
+            continue;
+        }
 
-            // Create a new instance of each original subnode.
-            for (NodePtr sourceSubNode : sourceSubGraph->getNodes())
-            {
-                string origName = sourceSubNode->getName();
-                string destName = createValidChildName(origName);
-                NodePtr destSubNode = addNode(sourceSubNode->getCategory(), destName);
+        const SubgraphImplementation& subgraphImpl = *implIt->second;
+        NodeGraphPtr sourceSubGraph = subgraphImpl.graph;
+        vector<PortElementPtr> processNodePorts = processNode->getDownstreamPorts();
+        std::unordered_map<NodePtr, NodePtr> subNodeMap;
+        vector<NodePtr>& destSubNodes = flattenedNodeMap[processNode];
 
-                destSubNode->copyContentFrom(sourceSubNode);
-                setChildIndex(destSubNode->getName(), getChildIndex(processNode->getName()));
+        // Create a new instance of each original subnode.
+        for (NodePtr sourceSubNode : subgraphImpl.nodes)
+        {
+            string destName = createValidChildName(sourceSubNode->getName());
+            NodePtr destSubNode = addNode(sourceSubNode->getCategory(), destName);
+            destSubNode->copyContentFrom(sourceSubNode);
 
-                // Store the mapping between subgraphs.
-                subNodeMap[sourceSubNode] = destSubNode;
+            // Store the mapping between subgraphs.
+            subNodeMap[sourceSubNode] = destSubNode;
+            destSubNodes.push_back(destSubNode);
 
-                // Add the subnode to the queue, allowing processing of nested subgraphs.
-                nodeQueue.push_back(destSubNode);
-            }
+            // Add the subnode to the queue, allowing processing of nested subgraphs.
+            nodeQueue.push_back(destSubNode);
+        }
 
-            // Update properties of generated subnodes.
-            for (const auto& subNodePair : subNodeMap)
-            {
-                NodePtr sourceSubNode = subNodePair.first;
-                NodePtr destSubNode = subNodePair.second;
+        // Update properties of generated subnodes.
+        for (size_t i = 0; i < subgraphImpl.nodes.size(); i++)
+        {
+            NodePtr destSubNode = destSubNodes[i];
 
-                // Update node connections.
-                for (PortElementPtr sourcePort : downstreamPortMap[sourceSubNode])
+            // Update node connections.
+            for (PortElementPtr sourcePort : subgraphImpl.downstreamPorts[i])
+            {
+                if (sourcePort->isA<Input>())
                 {
-                    if (sourcePort->isA<Input>())
+                    auto it = subNodeMap.find(sourcePort->getParent()->asA<Node>());
+                    if (it != subNodeMap.end())
                     {
-                        auto it = subNodeMap.find(sourcePort->getParent()->asA<Node>());
-                        if (it != subNodeMap.end())
+                        InputPtr processNodeInput = it->second->getInput(sourcePort->getName());
+                        if (processNodeInput)
                         {
-                            InputPtr processNodeInput = it->second->getInput(sourcePort->getName());
-                            if (processNodeInput)
-                            {
-                                processNodeInput->setNodeName(destSubNode->getName());
-                            }
+                            processNodeInput->setNodeName(destSubNode->getName());
                         }
                     }
-                    else if (sourcePort->isA<Output>())
+                }
+                else if (sourcePort->isA<Output>())
+                {
+                    for (PortElementPtr processNodePort : processNodePorts)
                     {
-                        for (PortElementPtr processNodePort : downstreamPortMap[processNode])
-                        {
-                            processNodePort->setNodeName(destSubNode->getName());
-                        }
+                        processNodePort->setNodeName(destSubNode->getName());
                     }
                 }
+            }
 
-                // Transfer interface properties.
-                for (InputPtr destInput : destSubNode->getInputs())
+            // Transfer interface properties.
+            for (InputPtr destInput : destSubNode->getInputs())
+            {
+                if (destInput->hasInterfaceName())
                 {
-                    if (destInput->hasInterfaceName())
+                    InputPtr sourceInput = processNode->getInput(destInput->getInterfaceName());
+                    if (sourceInput)
                     {
-                        InputPtr sourceInput = processNode->getInput(destInput->getInterfaceName());
-                        if (sourceInput)
-                        {
-                            destInput->copyContentFrom(sourceInput);
-                        }
-                        else
+                        destInput->copyContentFrom(sourceInput);
+                    }
+                    else
+                    {
+                        InputPtr declInput = nodeDef->getActiveInput(destInput->getInterfaceName());
+                        if (declInput)
                         {
-                            ConstInterfaceElementPtr declaration = declarationMap[processNode];
-                            InputPtr declInput = declaration ? declaration->getActiveInput(destInput->getInterfaceName()) : nullptr;
-                            if (declInput)
+                            if (declInput->hasValueString())
                             {
-                                if (declInput->hasValueString())
-                                {
-                                    destInput->setValueString(declInput->getValueString());
-                                }
-                                if (declInput->hasDefaultGeomPropString())
+                                destInput->setValueString(declInput->getValueString());
+                            }
+                            if (declInput->hasDefaultGeomPropString())
+                            {
+                                ConstGeomPropDefPtr geomPropDef = getDocument()->getGeomPropDef(declInput->getDefaultGeomPropString());
+                                if (geomPropDef)
                                 {
-                                    ConstGeomPropDefPtr geomPropDef = getDocument()->getGeomPropDef(declInput->getDefaultGeomPropString());
-                                    if (geomPropDef)
-                                    {
-                                        destInput->setConnectedNode(addGeomNode(geomPropDef, "geomNode"));
-                                    }
+                                    destInput->setConnectedNode(addGeomNode(geomPropDef, "geomNode"));
                                 }
                             }
-                            destInput->removeAttribute(ValueElement::INTERFACE_NAME_ATTRIBUTE);
                         }
+                        destInput->removeAttribute(ValueElement::INTERFACE_NAME_ATTRIBUTE);
                     }
                 }
             }
+        }
 
-            // Update downstream ports with connections to subgraph outputs.
-            for (PortElementPtr downstreamPort : downstreamPortMap[processNode])
+        // Update downstream ports with connections to subgraph outputs.
+        for (PortElementPtr downstreamPort : processNodePorts)
+        {
+            if (downstreamPort->hasOutputString())
             {
-                if (downstreamPort->hasOutputString())
+                OutputPtr subGraphOutput = sourceSubGraph->getOutput(downstreamPort->getOutputString());
+                if (subGraphOutput)
                 {
-                    OutputPtr subGraphOutput = sourceSubGraph->getOutput(downstreamPort->getOutputString());
-                    if (subGraphOutput)
+                    string destName = subGraphOutput->getNodeName();
+                    NodePtr sourceSubNode = sourceSubGraph->getNode(destName);
+                    NodePtr destNode = sourceSubNode ? subNodeMap[sourceSubNode] : nullptr;
+                    if (destNode)
                     {
-                        string destName = subGraphOutput->getNodeName();
-                        NodePtr sourceSubNode = sourceSubGraph->getNode(destName);
-                        NodePtr destNode = sourceSubNode ? subNodeMap[sourceSubNode] : nullptr;
-                        if (destNode)
-                        {
-                            destName = destNode->getName();
-                        }
-                        downstreamPort->setNodeName(destName);
-                        downstreamPort->setOutputString(EMPTY_STRING);
+                        destName = destNode->getName();
                     }
+                    downstreamPort->setNodeName(destName);
+                    downstreamPort->setOutputString(EMPTY_STRING);
                 }
             }
+        }
+
+        // The processed node has been replaced, so remove it from the graph.
+        removeNode(processNode->getName());
+    }
+
+    // Place the subnodes of each flattened node at its original position,
+    // followed by any other elements added in the process.
+    if (!flattenedNodeMap.empty())
+    {
+        vector<ElementPtr> childOrder;
+        std::unordered_set<ElementPtr> placedChildren;
+        childOrder.reserve(_childOrder.size());
+        for (ElementPtr child : origChildOrder)
+        {
+            appendFlattenedChild(child, flattenedNodeMap, childOrder, placedChildren);
+        }
+        for (ElementPtr child : _childOrder)
+        {
+            appendFlattenedChild(child, flattenedNodeMap, childOrder, placedChildren);
+        }
+        _childOrder = std::move(childOrder);
+        getDocument()->onChildOrderChange(getSelf());
+    }
+}
 
-            // The processed node has been replaced, so remove it from the graph.
-            removeNode(processNode->getName());
+std::unordered_map<ElementPtr, vector<PortElementPtr>> GraphElement::getDownstreamPortMap() const
+{
+    std::unordered_map<ElementPtr, vector<PortElementPtr>> downstreamPortMap;
+    ConstDocumentPtr doc = getDocument();
+    for (ElementPtr child : getChildren())
+    {
+        if (!child->isA<Node>() && !child->isA<NodeGraph>())
+        {
+            continue;
+        }
+        vector<PortElementPtr> ports = doc->getConnectedPorts(*child);
+        if (!ports.empty())
+        {
+            downstreamPortMap[child] = std::move(ports);
         }
     }
+    return downstreamPortMap;
 }
 
 vector<ElementPtr> GraphElement::topologicalSort() const
@@ -415,6 +533,9 @@ vector<ElementPtr> GraphElement::topologicalSort() const
         }
     }
 
+    // Gather the downstream ports of all children in a single pass.
+    std::unordered_map<ElementPtr, vector<PortElementPtr>> downstreamPortMap = getDownstreamPortMap();
+
     vector<ElementPtr> result;
     while (!childQueue.empty())
     {
@@ -425,9 +546,10 @@ vector<ElementPtr> GraphElement::topologicalSort() const
 
         // Find connected nodes and decrease their in-degree,
         // adding node to the queue if in-degrees becomes 0.
-        if (child->isA<Node>())
+        auto downstreamPorts = downstreamPortMap.find(child);
+        if (child->isA<Node>() && downstreamPorts != downstreamPortMap.end())
         {
-            for (PortElementPtr port : child->asA<Node>()->getDownstreamPorts())
+            for (PortElementPtr port : downstreamPorts->second)
             {
                 const ElementPtr downstreamElem = port->isA<Output>() ? port : port->getParent();
                 if (inDegree[downstreamElem] > 1)
@@ -725,21 +847,7 @@ InterfaceElementPtr NodeGraph::getImplementation() const
 
 vector<PortElementPtr> NodeGraph::getDownstreamPorts() const
 {
-    vector<PortElementPtr> downstreamPorts;
-    for (PortElementPtr port : getDocument()->getMatchingPorts(getQualifiedName(getName())))
-    {
-        ElementPtr node = port->getParent();
-        ElementPtr graph = node ? node->getParent() : nullptr;
-        if (graph && graph->isA<GraphElement>() && graph == getParent())
-        {
-            downstreamPorts.push_back(port);
-        }
-    }
-    std::sort(downstreamPorts.begin(), downstreamPorts.end(), [](const ConstElementPtr& a, const ConstElementPtr& b)
-    {
-        return a->getName() > b->getName();
-    });
-    return downstreamPorts;
+    return getDocument()->getConnectedPorts(*this);
 }
 
 bool NodeGraph::validate(string* message) const
@@ -166,6 +166,14 @@ class MX_CORE_API Node : public InterfaceElement
 
   public:
     static const string CATEGORY;
+
+  private:
+    friend class Document;
+
+    // The result of a previous nodedef resolution, which remains valid until
+    // the definitions of the document or the interface of the node change.
+    class NodeDefResolution;
+    mutable shared_ptr<const NodeDefResolution> _nodeDefResolution;
 };
 
 /// @class GraphElement
@@ -297,6 +305,11 @@ class MX_CORE_API GraphElement : public InterfaceElement
     ///     should be included and excluded from this process.
     void flattenSubgraphs(const string& target = EMPTY_STRING, NodePredicate filter = nullptr);
 
+    /// Return a map from each node and nodegraph in this graph to the port
+    /// elements downstream of it, matching the results of getDownstreamPorts.
+    /// Elements with no downstream ports are omitted from the map.
+    std::unordered_map<ElementPtr, vector<PortElementPtr>> getDownstreamPortMap() const;
+
     /// Return a vector of all children (nodes and outputs) sorted in
     /// topological order.
     vector<ElementPtr> topologicalSort() const;
@@ -0,0 +1,116 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_OBSERVER_H
+#define MATERIALX_OBSERVER_H
+
+/// @file
+/// Observation of changes to documents
+
+#include <MaterialXCore/Export.h>
+
+#include <MaterialXCore/Element.h>
+
+MATERIALX_NAMESPACE_BEGIN
+
+class Document;
+class DocumentChange;
+class DocumentObserver;
+
+/// A vector of document changes
+using DocumentChangeVec = vector<DocumentChange>;
+
+/// A shared pointer to a DocumentObserver
+using DocumentObserverPtr = shared_ptr<DocumentObserver>;
+
+/// @class DocumentChange
+/// A record of a single change to the content of a document.
+class MX_CORE_API DocumentChange
+{
+  public:
+    /// The kinds of change that may be made to a document.
+    enum Type
+    {
+        /// An element was added to its parent.
+        TypeAddElement,
+        /// An element was removed from its parent.
+        TypeRemoveElement,
+        /// An element was renamed.
+        TypeRenameElement,
+        /// An attribute of an element was set or removed.
+        TypeAttribute,
+        /// The children of an element were reordered.
+        TypeChildOrder
+    };
+
+  public:
+    DocumentChange(Type type, ElementPtr element, ElementPtr parent, const string& name) :
+        _type(type),
+        _element(element),
+        _parent(parent),
+        _name(name)
+    {
+    }
+    ~DocumentChange() { }
+
+    /// Return the type of this change.
+    Type getType() const
+    {
+        return _type;
+    }
+
+    /// Return the element that was changed.
+    ElementPtr getElement() const
+    {
+        return _element;
+    }
+
+    /// Return the parent of the element that was added or removed, or an
+    /// empty shared pointer for other types of change.
+    ElementPtr getParent() const
+    {
+        return _parent;
+    }
+
+    /// Return the name of the attribute that was changed, or the previous
+    /// name of an element that was renamed.  For attribute changes, an empty
+    /// name indicates that the category or the complete set of attributes of
+    /// the element may have changed.
+    const string& getName() const
+    {
+        return _name;
+    }
+
+  private:
+    Type _type;
+    ElementPtr _element;
+    ElementPtr _parent;
+    string _name;
+};
+
+/// @class DocumentObserver
+/// An interface for observing changes to a document.
+///
+/// Observers are registered with Document::addObserver.  Outside of a
+/// transaction, each change is reported as it is made.  Within a
+/// transaction, changes are recorded and reported together when the
+/// outermost transaction ends, omitting changes to the descendants of
+/// elements that were added within the same transaction, and repeated
+/// changes to the same attribute of an element.
+class MX_CORE_API DocumentObserver
+{
+  public:
+    DocumentObserver() { }
+    virtual ~DocumentObserver() { }
+
+    /// Called after the given changes have been made to a document.  Since
+    /// this method may be called as a ScopedTransaction is destroyed, it
+    /// should not throw exceptions.
+    virtual void onChanges(shared_ptr<Document> doc, const DocumentChangeVec& changes) = 0;
+};
+
+MATERIALX_NAMESPACE_END
+
+#endif
@@ -0,0 +1,217 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXCore/Patch.h>
+
+#include <algorithm>
+
+MATERIALX_NAMESPACE_BEGIN
+
+namespace
+{
+
+string getChildNamePath(const string& parentPath, const string& name)
+{
+    return parentPath.empty() ? name : parentPath + NAME_PATH_SEPARATOR + name;
+}
+
+void appendAddOperations(ConstElementPtr elem, const string& namePath, PatchOperationVec& patch)
+{
+    patch.emplace_back(PatchOperation::TypeAddElement, namePath, elem->getCategory());
+    for (size_t i = 0; i < elem->getAttributeCount(); i++)
+    {
+        patch.emplace_back(PatchOperation::TypeSetAttribute, namePath, elem->getAttributeName(i), elem->getAttributeValue(i));
+    }
+    for (ConstElementPtr child : elem->getChildren())
+    {
+        appendAddOperations(child, getChildNamePath(namePath, child->getName()), patch);
+    }
+}
+
+void appendPatchOperations(ConstElementPtr base, ConstElementPtr target, const string& namePath, PatchOperationVec& patch)
+{
+    if (base->getContentHash() == target->getContentHash())
+    {
+        return;
+    }
+
+    // Compare attributes.  Attributes present in both elements keep their
+    // positions up to the first difference in order, after which the
+    // remaining attributes are removed and set again in the target order.
+    vector<const string*> retainedNames;
+    for (size_t i = 0; i < base->getAttributeCount(); i++)
+    {
+        const string& attrName = base->getAttributeName(i);
+        if (target->hasAttribute(attrName))
+        {
+            retainedNames.push_back(&attrName);
+        }
+        else
+        {
+            patch.emplace_back(PatchOperation::TypeRemoveAttribute, namePath, attrName);
+        }
+    }
+    size_t orderedCount = 0;
+    while (orderedCount < retainedNames.size() && *retainedNames[orderedCount] == target->getAttributeName(orderedCount))
+    {
+        orderedCount++;
+    }
+    for (size_t i = orderedCount; i < retainedNames.size(); i++)
+    {
+        patch.emplace_back(PatchOperation::TypeRemoveAttribute, namePath, *retainedNames[i]);
+    }
+    for (size_t i = 0; i < target->getAttributeCount(); i++)
+    {
+        const string& attrName = target->getAttributeName(i);
+        const string& value = target->getAttributeValue(i);
+        if (i >= orderedCount || base->getAttribute(attrName) != value)
+        {
+            patch.emplace_back(PatchOperation::TypeSetAttribute, namePath, attrName, value);
+        }
+    }
+
+    // When both elements have matching children in the same order, recurse
+    // only into the children whose content differs.
+    const vector<ElementPtr>& baseChildren = base->getChildren();
+    const vector<ElementPtr>& targetChildren = target->getChildren();
+    bool childrenMatch = baseChildren.size() == targetChildren.size();
+    for (size_t i = 0; childrenMatch && i < baseChildren.size(); i++)
+    {
+        childrenMatch = baseChildren[i]->getName() == targetChildren[i]->getName() &&
+                        baseChildren[i]->getCategory() == targetChildren[i]->getCategory();
+    }
+    if (childrenMatch)
+    {
+        for (size_t i = 0; i < baseChildren.size(); i++)
+        {
+            if (baseChildren[i]->getContentHash() != targetChildren[i]->getContentHash())
+            {
+                appendPatchOperations(baseChildren[i], targetChildren[i],
+                                      getChildNamePath(namePath, baseChildren[i]->getName()), patch);
+            }
+        }
+        return;
+    }
+
+    // Remove children that are missing from the target, or whose category
+    // has changed, tracking the resulting order of children.
+    StringVec childOrder;
+    for (ConstElementPtr baseChild : baseChildren)
+    {
+        ConstElementPtr targetChild = target->getChild(baseChild->getName());
+        if (!targetChild || targetChild->getCategory() != baseChild->getCategory())
+        {
+            patch.emplace_back(PatchOperation::TypeRemoveElement, getChildNamePath(namePath, baseChild->getName()));
+        }
+        else
+        {
+            childOrder.push_back(baseChild->getName());
+        }
+    }
+
+    // Add new children, and recurse into children present in both elements.
+    for (ConstElementPtr targetChild : targetChildren)
+    {
+        const string childPath = getChildNamePath(namePath, targetChild->getName());
+        ConstElementPtr baseChild = base->getChild(targetChild->getName());
+        if (baseChild && baseChild->getCategory() == targetChild->getCategory())
+        {
+            appendPatchOperations(baseChild, targetChild, childPath, patch);
+        }
+        else
+        {
+            appendAddOperations(targetChild, childPath, patch);
+            childOrder.push_back(targetChild->getName());
+        }
+    }
+
+    // Move children that are out of order.
+    for (size_t i = 0; i < targetChildren.size(); i++)
+    {
+        const string& name = targetChildren[i]->getName();
+        if (childOrder[i] != name)
+        {
+            StringVec::iterator it = std::find(childOrder.begin() + i, childOrder.end(), name);
+            std::rotate(childOrder.begin() + i, it, it + 1);
+            patch.emplace_back(PatchOperation::TypeSetChildIndex, getChildNamePath(namePath, name),
+                               EMPTY_STRING, EMPTY_STRING, (int) i);
+        }
+    }
+}
+
+} // anonymous namespace
+
+PatchOperationVec createPatch(ConstElementPtr base, ConstElementPtr target)
+{
+    PatchOperationVec patch;
+    appendPatchOperations(base, target, EMPTY_STRING, patch);
+    return patch;
+}
+
+void applyPatch(ElementPtr elem, const PatchOperationVec& patch)
+{
+    ScopedTransaction transaction(elem->getDocument());
+
+    // Consecutive operations often address the same element, so the most
+    // recently resolved element is retained.
+    string cachedPath;
+    ElementPtr cachedElem = elem;
+    auto getElement = [&](const string& namePath)
+    {
+        if (namePath != cachedPath || !cachedElem)
+        {
+            cachedPath = namePath;
+            cachedElem = elem->getDescendant(namePath);
+            if (!cachedElem)
+            {
+                throw Exception("Patch target not found: " + namePath);
+            }
+        }
+        return cachedElem;
+    };
+
+    for (const PatchOperation& op : patch)
+    {
+        const string& namePath = op.getNamePath();
+        switch (op.getType())
+        {
+            case PatchOperation::TypeSetAttribute:
+                getElement(namePath)->setAttribute(op.getName(), op.getValue());
+                break;
+            case PatchOperation::TypeRemoveAttribute:
+                getElement(namePath)->removeAttribute(op.getName());
+                break;
+            default:
+            {
+                // The remaining operations are applied through the parent.
+                size_t pos = namePath.rfind(NAME_PATH_SEPARATOR);
+                const string parentPath = (pos == string::npos) ? EMPTY_STRING : namePath.substr(0, pos);
+                const string name = (pos == string::npos) ? namePath : namePath.substr(pos + 1);
+                ElementPtr parent = getElement(parentPath);
+                if (op.getType() == PatchOperation::TypeAddElement)
+                {
+                    cachedElem = parent->addChildOfCategory(op.getName(), name);
+                    cachedPath = namePath;
+                    break;
+                }
+                if (!parent->getChild(name))
+                {
+                    throw Exception("Patch target not found: " + namePath);
+                }
+                if (op.getType() == PatchOperation::TypeRemoveElement)
+                {
+                    parent->removeChild(name);
+                }
+                else
+                {
+                    parent->setChildIndex(name, op.getIndex());
+                }
+                break;
+            }
+        }
+    }
+}
+
+MATERIALX_NAMESPACE_END
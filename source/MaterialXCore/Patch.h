@@ -0,0 +1,136 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_PATCH_H
+#define MATERIALX_PATCH_H
+
+/// @file
+/// Structural differences between documents
+
+#include <MaterialXCore/Export.h>
+
+#include <MaterialXCore/Document.h>
+
+MATERIALX_NAMESPACE_BEGIN
+
+class PatchOperation;
+
+/// A vector of patch operations
+using PatchOperationVec = vector<PatchOperation>;
+
+/// @class PatchOperation
+/// A single edit within a patch, addressing its target element by name path.
+///
+/// Patch operations hold only strings and integers, so they may be stored or
+/// transmitted independently of the documents from which they were created.
+class MX_CORE_API PatchOperation
+{
+  public:
+    /// The kinds of edit that a patch may contain.
+    enum Type
+    {
+        /// Add an element with the given category, appending it to the
+        /// children of its parent.
+        TypeAddElement,
+        /// Remove an element and its descendants.
+        TypeRemoveElement,
+        /// Set an attribute of an element to the given value.
+        TypeSetAttribute,
+        /// Remove an attribute of an element.
+        TypeRemoveAttribute,
+        /// Move an element to the given index within the children of its parent.
+        TypeSetChildIndex
+    };
+
+  public:
+    PatchOperation(Type type, const string& namePath, const string& name = EMPTY_STRING,
+                   const string& value = EMPTY_STRING, int index = 0) :
+        _type(type),
+        _namePath(namePath),
+        _name(name),
+        _value(value),
+        _index(index)
+    {
+    }
+    ~PatchOperation() { }
+
+    bool operator==(const PatchOperation& rhs) const
+    {
+        return _type == rhs._type &&
+               _namePath == rhs._namePath &&
+               _name == rhs._name &&
+               _value == rhs._value &&
+               _index == rhs._index;
+    }
+    bool operator!=(const PatchOperation& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    /// Return the type of this operation.
+    Type getType() const
+    {
+        return _type;
+    }
+
+    /// Return the name path of the target element, relative to the root
+    /// element to which the patch is applied.
+    const string& getNamePath() const
+    {
+        return _namePath;
+    }
+
+    /// Return the category of the added element for TypeAddElement, or the
+    /// name of the attribute for TypeSetAttribute and TypeRemoveAttribute.
+    const string& getName() const
+    {
+        return _name;
+    }
+
+    /// Return the new value of the attribute for TypeSetAttribute.
+    const string& getValue() const
+    {
+        return _value;
+    }
+
+    /// Return the new child index of the element for TypeSetChildIndex.
+    int getIndex() const
+    {
+        return _index;
+    }
+
+  private:
+    Type _type;
+    string _namePath;
+    string _name;
+    string _value;
+    int _index;
+};
+
+/// Return the patch that transforms the content of the base element into the
+/// content of the target element, as an ordered list of operations keyed by
+/// name paths relative to the given elements.
+///
+/// Subtrees with equal content hashes are skipped without further
+/// comparison, so the cost of a patch is proportional to the size of the
+/// edited regions of the two trees.  Since content hashes are independent
+/// of attribute order, attribute order is restored only for elements whose
+/// content differs.  The categories and names of the two given elements
+/// themselves are not compared.
+/// @relates PatchOperation
+MX_CORE_API PatchOperationVec createPatch(ConstElementPtr base, ConstElementPtr target);
+
+/// Apply the given patch to an element, which should have the content of
+/// the base element from which the patch was created.  If the element
+/// belongs to a document, then all edits are reported to the observers of
+/// the document as a single transaction.
+/// @throws Exception if an operation addresses a missing element, or adds
+///    an element that already exists.
+/// @relates PatchOperation
+MX_CORE_API void applyPatch(ElementPtr elem, const PatchOperationVec& patch);
+
+MATERIALX_NAMESPACE_END
+
+#endif
@@ -12,6 +12,7 @@ MATERIALX_NAMESPACE_BEGIN
 const Edge NULL_EDGE(nullptr, nullptr, nullptr);
 
 const TreeIterator NULL_TREE_ITERATOR(nullptr);
+const RawTreeIterator NULL_RAW_TREE_ITERATOR(nullptr);
 const GraphIterator NULL_GRAPH_ITERATOR(nullptr);
 const InheritanceIterator NULL_INHERITANCE_ITERATOR(nullptr);
 
@@ -78,6 +79,49 @@ TreeIterator& TreeIterator::operator++()
     }
 }
 
+//
+// RawTreeIterator methods
+//
+
+const RawTreeIterator& RawTreeIterator::end()
+{
+    return NULL_RAW_TREE_ITERATOR;
+}
+
+RawTreeIterator& RawTreeIterator::operator++()
+{
+    if (!_prune && _elem && !_elem->getChildren().empty())
+    {
+        // Traverse to the first child of this element.
+        _stack.emplace_back(_elem, 0);
+        _elem = _elem->getChildren()[0].get();
+        return *this;
+    }
+    _prune = false;
+
+    while (true)
+    {
+        if (_stack.empty())
+        {
+            // Traversal is complete.
+            _elem = nullptr;
+            return *this;
+        }
+
+        // Traverse to our siblings.
+        StackFrame& parentFrame = _stack.back();
+        const vector<ElementPtr>& siblings = parentFrame.first->getChildren();
+        if (parentFrame.second + 1 < siblings.size())
+        {
+            _elem = siblings[++parentFrame.second].get();
+            return *this;
+        }
+
+        // Traverse to our parent's siblings.
+        _stack.pop_back();
+    }
+}
+
 //
 // GraphIterator methods
 //
@@ -184,6 +184,112 @@ class MX_CORE_API TreeIterator
     size_t _holdCount;
 };
 
+/// @class RawTreeIterator
+/// An iterator object representing the state of a tree traversal, which
+/// visits elements through raw pointers.
+///
+/// Unlike TreeIterator, no shared pointers are copied as the traversal
+/// advances, so no reference counts are updated.  The iterator and the
+/// pointers that it returns are valid only while the traversed tree is not
+/// modified.
+///
+/// @sa Element::traverseTreeRaw
+class MX_CORE_API RawTreeIterator
+{
+  public:
+    explicit RawTreeIterator(Element* elem) :
+        _elem(elem),
+        _prune(false)
+    {
+    }
+    ~RawTreeIterator() { }
+
+  private:
+    using StackFrame = std::pair<Element*, size_t>;
+
+  public:
+    bool operator==(const RawTreeIterator& rhs) const
+    {
+        return _elem == rhs._elem &&
+               _stack == rhs._stack &&
+               _prune == rhs._prune;
+    }
+    bool operator!=(const RawTreeIterator& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    /// Dereference this iterator, returning the current element in the
+    /// traversal.
+    Element* operator*() const
+    {
+        return _elem;
+    }
+
+    /// Iterate to the next element in the traversal.
+    RawTreeIterator& operator++();
+
+    /// @name Elements
+    /// @{
+
+    /// Return the current element in the traversal.
+    Element* getElement() const
+    {
+        return _elem;
+    }
+
+    /// @}
+    /// @name Depth
+    /// @{
+
+    /// Return the element depth of the current traversal, where the starting
+    /// element represents a depth of zero.
+    size_t getElementDepth() const
+    {
+        return _stack.size();
+    }
+
+    /// @}
+    /// @name Pruning
+    /// @{
+
+    /// Set the prune subtree flag, which controls whether the current subtree
+    /// is pruned from traversal.
+    /// @param prune If set to true, then the current subtree will be pruned.
+    void setPruneSubtree(bool prune)
+    {
+        _prune = prune;
+    }
+
+    /// Return the prune subtree flag, which controls whether the current
+    /// subtree is pruned from traversal.
+    bool getPruneSubtree() const
+    {
+        return _prune;
+    }
+
+    /// @}
+    /// @name Range Methods
+    /// @{
+
+    /// Interpret this object as an iteration range, and return its begin
+    /// iterator.
+    RawTreeIterator& begin()
+    {
+        return *this;
+    }
+
+    /// Return the sentinel end iterator for this class.
+    static const RawTreeIterator& end();
+
+    /// @}
+
+  private:
+    Element* _elem;
+    vector<StackFrame> _stack;
+    bool _prune;
+};
+
 /// @class GraphIterator
 /// An iterator object representing the state of an upstream graph traversal.
 ///
@@ -393,6 +499,7 @@ class MX_CORE_API ExceptionFoundCycle : public Exception
 extern MX_CORE_API const Edge NULL_EDGE;
 
 extern MX_CORE_API const TreeIterator NULL_TREE_ITERATOR;
+extern MX_CORE_API const RawTreeIterator NULL_RAW_TREE_ITERATOR;
 extern MX_CORE_API const GraphIterator NULL_GRAPH_ITERATOR;
 extern MX_CORE_API const InheritanceIterator NULL_INHERITANCE_ITERATOR;
 
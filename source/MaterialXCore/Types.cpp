@@ -5,6 +5,16 @@
 
 #include <MaterialXCore/Types.h>
 
+#if !defined(MATERIALX_DISABLE_SIMD)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #include <emmintrin.h>
+        #define MATERIALX_SIMD_SSE2
+    #elif defined(__ARM_NEON) || defined(_M_ARM64)
+        #include <arm_neon.h>
+        #define MATERIALX_SIMD_NEON
+    #endif
+#endif
+
 MATERIALX_NAMESPACE_BEGIN
 
 const string DEFAULT_TYPE_STRING = "color3";
@@ -39,6 +49,89 @@ const Matrix44 Matrix44::IDENTITY(1, 0, 0, 0,
                                   0, 0, 1, 0,
                                   0, 0, 0, 1);
 
+namespace
+{
+
+// A row of four floats, with the operations needed by the matrix kernels
+// below.  The SIMD and scalar variants accumulate in the same order, though
+// the scalar variant may differ in rounding where the compiler contracts
+// its products and sums into fused multiply-adds.
+#if defined(MATERIALX_SIMD_SSE2)
+
+using Row4 = __m128;
+
+Row4 loadRow(const float* p) { return _mm_loadu_ps(p); }
+void storeRow(float* p, Row4 r) { _mm_storeu_ps(p, r); }
+Row4 splatRow(float s) { return _mm_set1_ps(s); }
+Row4 addRows(Row4 a, Row4 b) { return _mm_add_ps(a, b); }
+Row4 mulRows(Row4 a, Row4 b) { return _mm_mul_ps(a, b); }
+
+#elif defined(MATERIALX_SIMD_NEON)
+
+using Row4 = float32x4_t;
+
+Row4 loadRow(const float* p) { return vld1q_f32(p); }
+void storeRow(float* p, Row4 r) { vst1q_f32(p, r); }
+Row4 splatRow(float s) { return vdupq_n_f32(s); }
+Row4 addRows(Row4 a, Row4 b) { return vaddq_f32(a, b); }
+Row4 mulRows(Row4 a, Row4 b) { return vmulq_f32(a, b); }
+
+#else
+
+struct Row4
+{
+    float v[4];
+};
+
+Row4 loadRow(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+void storeRow(float* p, Row4 r) { std::copy(r.v, r.v + 4, p); }
+Row4 splatRow(float s) { return { { s, s, s, s } }; }
+Row4 addRows(Row4 a, Row4 b) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+Row4 mulRows(Row4 a, Row4 b) { return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+
+#endif
+
+// The rows of a 4x4 matrix, loaded once for repeated transformations.
+struct MatrixRows
+{
+    explicit MatrixRows(const Matrix44& m) :
+        r0(loadRow(m[0].data())),
+        r1(loadRow(m[1].data())),
+        r2(loadRow(m[2].data())),
+        r3(loadRow(m[3].data()))
+    {
+    }
+
+    // Return the product of the row vector (x, y, z, w) and the matrix,
+    // accumulating terms in the same order as the scalar expression
+    // x * m0 + y * m1 + z * m2 + w * m3.
+    Row4 transform(float x, float y, float z, float w) const
+    {
+        Row4 res = mulRows(splatRow(x), r0);
+        res = addRows(res, mulRows(splatRow(y), r1));
+        res = addRows(res, mulRows(splatRow(z), r2));
+        return addRows(res, mulRows(splatRow(w), r3));
+    }
+
+    Row4 r0, r1, r2, r3;
+};
+
+// Transform an array of 3D vectors by the given matrix, with the given
+// homogeneous coordinate.
+void transformVector3Array(const Matrix44& m, const Vector3* in, Vector3* out, size_t count, float w)
+{
+    MatrixRows rows(m);
+    float res[4];
+    for (size_t i = 0; i < count; i++)
+    {
+        const float* v = in[i].data();
+        storeRow(res, rows.transform(v[0], v[1], v[2], w));
+        out[i] = Vector3(res[0], res[1], res[2]);
+    }
+}
+
+} // anonymous namespace
+
 //
 // Color3 methods
 //
@@ -162,6 +255,24 @@ Matrix33 Matrix33::createRotation(float angle)
 // Matrix44 methods
 //
 
+Matrix44 Matrix44::operator*(const Matrix44& rhs) const
+{
+    // Accumulate from zero, matching the summation order of the generic
+    // MatrixN product.
+    MatrixRows rows(rhs);
+    Matrix44 res(Uninit{});
+    for (size_t i = 0; i < 4; i++)
+    {
+        Row4 row = splatRow(0.0f);
+        row = addRows(row, mulRows(splatRow(_arr[i][0]), rows.r0));
+        row = addRows(row, mulRows(splatRow(_arr[i][1]), rows.r1));
+        row = addRows(row, mulRows(splatRow(_arr[i][2]), rows.r2));
+        row = addRows(row, mulRows(splatRow(_arr[i][3]), rows.r3));
+        storeRow(res._arr[i].data(), row);
+    }
+    return res;
+}
+
 Matrix44 Matrix44::getTranspose() const
 {
     return Matrix44(_arr[0][0], _arr[1][0], _arr[2][0], _arr[3][0],
@@ -236,23 +347,23 @@ Matrix44 Matrix44::getAdjugate() const
 
 Vector4 Matrix44::multiply(const Vector4& v) const
 {
-    return Vector4(
-      v[0]*_arr[0][0] + v[1]*_arr[1][0] + v[2]*_arr[2][0] + v[3]*_arr[3][0],
-      v[0]*_arr[0][1] + v[1]*_arr[1][1] + v[2]*_arr[2][1] + v[3]*_arr[3][1],
-      v[0]*_arr[0][2] + v[1]*_arr[1][2] + v[2]*_arr[2][2] + v[3]*_arr[3][2],
-      v[0]*_arr[0][3] + v[1]*_arr[1][3] + v[2]*_arr[2][3] + v[3]*_arr[3][3]);
+    Vector4 res(Uninit{});
+    storeRow(res.data(), MatrixRows(*this).transform(v[0], v[1], v[2], v[3]));
+    return res;
 }
 
 Vector3 Matrix44::transformPoint(const Vector3& v) const
 {
-    Vector4 res = multiply(Vector4(v[0], v[1], v[2], 1.0f));
-    return Vector3(res[0], res[1], res[2]);
+    Vector3 res(Uninit{});
+    transformVector3Array(*this, &v, &res, 1, 1.0f);
+    return res;
 }
 
 Vector3 Matrix44::transformVector(const Vector3& v) const
 {
-    Vector4 res = multiply(Vector4(v[0], v[1], v[2], 0.0f));
-    return Vector3(res[0], res[1], res[2]);
+    Vector3 res(Uninit{});
+    transformVector3Array(*this, &v, &res, 1, 0.0f);
+    return res;
 }
 
 Vector3 Matrix44::transformNormal(const Vector3& v) const
@@ -260,6 +371,21 @@ Vector3 Matrix44::transformNormal(const Vector3& v) const
     return getInverse().getTranspose().transformVector(v);
 }
 
+void Matrix44::transformPoints(const Vector3* points, Vector3* result, size_t count) const
+{
+    transformVector3Array(*this, points, result, count, 1.0f);
+}
+
+void Matrix44::transformVectors(const Vector3* vectors, Vector3* result, size_t count) const
+{
+    transformVector3Array(*this, vectors, result, count, 0.0f);
+}
+
+void Matrix44::transformNormals(const Vector3* normals, Vector3* result, size_t count) const
+{
+    transformVector3Array(getInverse().getTranspose(), normals, result, count, 0.0f);
+}
+
 Matrix44 Matrix44::createTranslation(const Vector3& v)
 {
     return Matrix44(1.0f, 0.0f, 0.0f, 0.0f,
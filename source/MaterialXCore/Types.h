@@ -100,7 +100,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     {
         V res(Uninit{});
         for (size_t i = 0; i < N; i++)
-            res[i] = _arr[i] + rhs[i];
+            res._arr[i] = _arr[i] + rhs._arr[i];
         return res;
     }
 
@@ -108,7 +108,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     VectorN& operator+=(const V& rhs)
     {
         for (size_t i = 0; i < N; i++)
-            _arr[i] += rhs[i];
+            _arr[i] += rhs._arr[i];
         return *this;
     }
 
@@ -117,7 +117,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     {
         V res(Uninit{});
         for (size_t i = 0; i < N; i++)
-            res[i] = _arr[i] - rhs[i];
+            res._arr[i] = _arr[i] - rhs._arr[i];
         return res;
     }
 
@@ -125,7 +125,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     VectorN& operator-=(const V& rhs)
     {
         for (size_t i = 0; i < N; i++)
-            _arr[i] -= rhs[i];
+            _arr[i] -= rhs._arr[i];
         return *this;
     }
 
@@ -134,7 +134,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     {
         V res(Uninit{});
         for (size_t i = 0; i < N; i++)
-            res[i] = _arr[i] * rhs[i];
+            res._arr[i] = _arr[i] * rhs._arr[i];
         return res;
     }
 
@@ -142,7 +142,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     VectorN& operator*=(const V& rhs)
     {
         for (size_t i = 0; i < N; i++)
-            _arr[i] *= rhs[i];
+            _arr[i] *= rhs._arr[i];
         return *this;
     }
 
@@ -151,7 +151,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     {
         V res(Uninit{});
         for (size_t i = 0; i < N; i++)
-            res[i] = _arr[i] / rhs[i];
+            res._arr[i] = _arr[i] / rhs._arr[i];
         return res;
     }
 
@@ -159,7 +159,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     VectorN& operator/=(const V& rhs)
     {
         for (size_t i = 0; i < N; i++)
-            _arr[i] /= rhs[i];
+            _arr[i] /= rhs._arr[i];
         return *this;
     }
 
@@ -168,7 +168,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     {
         V res(Uninit{});
         for (size_t i = 0; i < N; i++)
-            res[i] = _arr[i] * s;
+            res._arr[i] = _arr[i] * s;
         return res;
     }
 
@@ -185,7 +185,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     {
         V res(Uninit{});
         for (size_t i = 0; i < N; i++)
-            res[i] = _arr[i] / s;
+            res._arr[i] = _arr[i] / s;
         return res;
     }
 
@@ -202,7 +202,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     {
         V res(Uninit{});
         for (size_t i = 0; i < N; i++)
-            res[i] = -_arr[i];
+            res._arr[i] = -_arr[i];
         return res;
     }
 
@@ -230,7 +230,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     {
         S res{};
         for (size_t i = 0; i < N; i++)
-            res += _arr[i] * rhs[i];
+            res += _arr[i] * rhs._arr[i];
         return res;
     }
 
@@ -296,7 +296,7 @@ class MX_CORE_API Vector2 : public VectorN<Vector2, float, 2>
     /// Return the cross product of two vectors.
     float cross(const Vector2& rhs) const
     {
-        return _arr[0] * rhs[1] - _arr[1] * rhs[0];
+        return _arr[0] * rhs._arr[1] - _arr[1] * rhs._arr[0];
     }
 };
 
@@ -316,9 +316,9 @@ class MX_CORE_API Vector3 : public VectorN<Vector3, float, 3>
     /// Return the cross product of two vectors.
     Vector3 cross(const Vector3& rhs) const
     {
-        return Vector3(_arr[1] * rhs[2] - _arr[2] * rhs[1],
-                       _arr[2] * rhs[0] - _arr[0] * rhs[2],
-                       _arr[0] * rhs[1] - _arr[1] * rhs[0]);
+        return Vector3(_arr[1] * rhs._arr[2] - _arr[2] * rhs._arr[1],
+                       _arr[2] * rhs._arr[0] - _arr[0] * rhs._arr[2],
+                       _arr[0] * rhs._arr[1] - _arr[1] * rhs._arr[0]);
     }
 };
 
@@ -413,7 +413,7 @@ template <class M, class S, size_t N> class MatrixN : public MatrixBase
         {
             for (size_t j = 0; j < N; j++)
             {
-                if (std::abs(_arr[i][j] - rhs[i][j]) > tolerance)
+                if (std::abs(_arr[i][j] - rhs._arr[i][j]) > tolerance)
                 {
                     return false;
                 }
@@ -442,7 +442,7 @@ template <class M, class S, size_t N> class MatrixN : public MatrixBase
         M res(Uninit{});
         for (size_t i = 0; i < N; i++)
             for (size_t j = 0; j < N; j++)
-                res[i][j] = _arr[i][j] + rhs[i][j];
+                res._arr[i][j] = _arr[i][j] + rhs._arr[i][j];
         return res;
     }
 
@@ -459,7 +459,7 @@ template <class M, class S, size_t N> class MatrixN : public MatrixBase
         M res(Uninit{});
         for (size_t i = 0; i < N; i++)
             for (size_t j = 0; j < N; j++)
-                res[i][j] = _arr[i][j] - rhs[i][j];
+                res._arr[i][j] = _arr[i][j] - rhs._arr[i][j];
         return res;
     }
 
@@ -476,7 +476,7 @@ template <class M, class S, size_t N> class MatrixN : public MatrixBase
         M res(Uninit{});
         for (size_t i = 0; i < N; i++)
             for (size_t j = 0; j < N; j++)
-                res[i][j] = _arr[i][j] * s;
+                res._arr[i][j] = _arr[i][j] * s;
         return res;
     }
 
@@ -493,7 +493,7 @@ template <class M, class S, size_t N> class MatrixN : public MatrixBase
         M res(Uninit{});
         for (size_t i = 0; i < N; i++)
             for (size_t j = 0; j < N; j++)
-                res[i][j] = _arr[i][j] / s;
+                res._arr[i][j] = _arr[i][j] / s;
         return res;
     }
 
@@ -515,14 +515,14 @@ template <class M, class S, size_t N> class MatrixN : public MatrixBase
         for (size_t i = 0; i < N; i++)
             for (size_t j = 0; j < N; j++)
                 for (size_t k = 0; k < N; k++)
-                    res[i][j] += _arr[i][k] * rhs[k][j];
+                    res._arr[i][j] += _arr[i][k] * rhs._arr[k][j];
         return res;
     }
 
     /// Compute the matrix product.
     MatrixN& operator*=(const M& rhs)
     {
-        *this = *this * rhs;
+        *this = static_cast<const M&>(*this) * rhs;
         return *this;
     }
 
@@ -530,7 +530,7 @@ template <class M, class S, size_t N> class MatrixN : public MatrixBase
     /// first matrix and the inverse of the second).
     M operator/(const M& rhs) const
     {
-        return *this * rhs.getInverse();
+        return static_cast<const M&>(*this) * rhs.getInverse();
     }
 
     /// Divide the first matrix by the second (computed as the product of the
@@ -669,6 +669,15 @@ class MX_CORE_API Matrix44 : public MatrixN<Matrix44, float, 4>
                  RowArray{ m30, m31, m32, m33 } };
     }
 
+    /// @name Matrix Algebra
+    /// @{
+
+    using MatrixN<Matrix44, float, 4>::operator*;
+
+    /// Compute the matrix product.
+    Matrix44 operator*(const Matrix44& rhs) const;
+
+    /// @}
     /// @name Matrix Operations
     /// @{
 
@@ -703,6 +712,19 @@ class MX_CORE_API Matrix44 : public MatrixN<Matrix44, float, 4>
     /// Transform the given 3D normal vector.
     Vector3 transformNormal(const Vector3& v) const;
 
+    /// Transform an array of 3D points, writing the results to the given
+    /// output array, which may be the same as the input array.
+    void transformPoints(const Vector3* points, Vector3* result, size_t count) const;
+
+    /// Transform an array of 3D direction vectors, writing the results to
+    /// the given output array, which may be the same as the input array.
+    void transformVectors(const Vector3* vectors, Vector3* result, size_t count) const;
+
+    /// Transform an array of 3D normal vectors, writing the results to the
+    /// given output array, which may be the same as the input array.  The
+    /// inverse transpose of the matrix is computed once for the whole array.
+    void transformNormals(const Vector3* normals, Vector3* result, size_t count) const;
+
     /// Create a translation matrix.
     static Matrix44 createTranslation(const Vector3& v);
 
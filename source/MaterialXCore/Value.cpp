@@ -5,6 +5,8 @@
 
 #include <MaterialXCore/Value.h>
 
+#include <cctype>
+#include <charconv>
 #include <iomanip>
 #include <sstream>
 #include <type_traits>
@@ -28,16 +30,124 @@ template <class T> class is_std_vector<vector<T>> : public std::true_type { };
 template <class T> using enable_if_std_vector_t =
     typename std::enable_if<is_std_vector<T>::value, T>::type;
 
-template <class T> void stringToData(const string& str, T& data)
+// Parse a numeric token with stream extraction, which supports the full
+// range of inputs accepted by the original MaterialX parser.
+template <class T> bool streamToNumber(const char* first, const char* last, T& data)
 {
-    std::stringstream ss(str);
+    std::istringstream ss(string(first, last));
     ss.imbue(std::locale::classic());
-    if (!(ss >> data))
+    return bool(ss >> data);
+}
+
+// Parse a numeric token, returning true on success.  Tokens in the common
+// form of an optional minus sign followed by digits are parsed without
+// allocation through std::from_chars, and all other tokens fall back to
+// stream extraction, so that both paths accept and reject the same inputs.
+template <class T> bool parseNumber(const char* first, const char* last, T& data)
+{
+#if defined(__cpp_lib_to_chars)
+    const char* digits = (first != last && *first == '-') ? first + 1 : first;
+    if (digits != last && (std::isdigit((unsigned char) *digits) || *digits == '.'))
+    {
+        std::from_chars_result result = std::from_chars(first, last, data);
+        if (result.ec == std::errc())
+        {
+            return true;
+        }
+    }
+#endif
+    return streamToNumber(first, last, data);
+}
+
+// Format a numeric value with the current float format and precision,
+// appending the result to the given string.
+template <class T> void appendNumber(const T& data, string& str)
+{
+    const Value::FloatFormat fmt = Value::getFloatFormat();
+    const int precision = Value::getFloatPrecision();
+#if defined(__cpp_lib_to_chars)
+    char buffer[64];
+    std::to_chars_result result;
+    if constexpr (std::is_integral<T>::value)
+    {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), data);
+    }
+    else
+    {
+        if (precision < 0)
+        {
+            result.ec = std::errc::invalid_argument;
+        }
+        else
+        {
+            std::chars_format charsFormat = fmt == Value::FloatFormatFixed ? std::chars_format::fixed :
+                                            fmt == Value::FloatFormatScientific ? std::chars_format::scientific :
+                                                                                  std::chars_format::general;
+            result = std::to_chars(buffer, buffer + sizeof(buffer), data, charsFormat, precision);
+        }
+    }
+    if (result.ec == std::errc())
+    {
+        str.append(buffer, result.ptr);
+        return;
+    }
+#endif
+
+    std::ostringstream ss;
+    ss.imbue(std::locale::classic());
+
+    // Set float format and precision for the stream
+    ss.setf(std::ios_base::fmtflags(
+            (fmt == Value::FloatFormatFixed ? std::ios_base::fixed :
+            (fmt == Value::FloatFormatScientific ? std::ios_base::scientific : 0))),
+        std::ios_base::floatfield);
+    ss.precision(precision);
+
+    ss << data;
+    str += ss.str();
+}
+
+// Call the given function for each token of the given string, as delimited
+// by any of the given separator characters, skipping empty tokens.
+template <class F> void forEachToken(const string& str, const string& sep, F func)
+{
+    string::size_type lastPos = str.find_first_not_of(sep, 0);
+    string::size_type pos = str.find_first_of(sep, lastPos);
+    while (pos != string::npos || lastPos != string::npos)
+    {
+        const char* first = str.data() + lastPos;
+        func(first, first + ((pos == string::npos ? str.size() : pos) - lastPos));
+        lastPos = str.find_first_not_of(sep, pos);
+        pos = str.find_first_of(sep, lastPos);
+    }
+}
+
+// Return the number of tokens in the given string, as delimited by any of
+// the given separator characters.
+size_t countTokens(const string& str, const string& sep)
+{
+    size_t count = 0;
+    forEachToken(str, sep, [&count](const char*, const char*)
+    {
+        count++;
+    });
+    return count;
+}
+
+// Parse the given numeric token, throwing an exception on failure.
+template <class T> void tokenToData(const char* first, const char* last, T& data)
+{
+    if (!parseNumber(first, last, data))
     {
-        throw ExceptionTypeError("Type mismatch in generic stringToData: " + str);
+        throw ExceptionTypeError("Type mismatch in generic stringToData: " + string(first, last));
     }
 }
 
+template <class T> void stringToData(const string& str, T& data)
+{
+    tokenToData(str.data(), str.data() + str.size(), data);
+}
+
 template <> void stringToData(const string& str, bool& data)
 {
     if (str == VALUE_STRING_TRUE)
@@ -55,31 +165,29 @@ template <> void stringToData(const string& str, string& data)
 
 template <class T> void stringToData(const string& str, enable_if_mx_vector_t<T>& data)
 {
-    StringVec tokens = splitString(str, ARRAY_VALID_SEPARATORS);
-    if (tokens.size() != data.numElements())
+    if (countTokens(str, ARRAY_VALID_SEPARATORS) != data.numElements())
     {
         throw ExceptionTypeError("Type mismatch in vector stringToData: " + str);
     }
-    for (size_t i = 0; i < data.numElements(); i++)
+    size_t i = 0;
+    forEachToken(str, ARRAY_VALID_SEPARATORS, [&](const char* first, const char* last)
     {
-        stringToData(tokens[i], data[i]);
-    }
+        tokenToData(first, last, data[i++]);
+    });
 }
 
 template <class T> void stringToData(const string& str, enable_if_mx_matrix_t<T>& data)
 {
-    StringVec tokens = splitString(str, ARRAY_VALID_SEPARATORS);
-    if (tokens.size() != data.numRows() * data.numColumns())
+    if (countTokens(str, ARRAY_VALID_SEPARATORS) != data.numRows() * data.numColumns())
     {
         throw ExceptionTypeError("Type mismatch in matrix stringToData: " + str);
     }
-    for (size_t i = 0; i < data.numRows(); i++)
+    size_t i = 0;
+    forEachToken(str, ARRAY_VALID_SEPARATORS, [&](const char* first, const char* last)
     {
-        for (size_t j = 0; j < data.numColumns(); j++)
-        {
-            stringToData(tokens[i * data.numRows() + j], data[i][j]);
-        }
-    }
+        tokenToData(first, last, data[i / data.numRows()][i % data.numRows()]);
+        i++;
+    });
 }
 
 template <class T> void stringToData(const string& str, enable_if_std_vector_t<T>& data)
@@ -87,48 +195,54 @@ template <class T> void stringToData(const string& str, enable_if_std_vector_t<T
     // This code path parses an array of arbitrary substrings, so we split the string
     // in a fashion that preserves substrings with internal spaces.
     const string COMMA_SEPARATOR = ",";
-    for (const string& token : splitString(str, COMMA_SEPARATOR))
+    forEachToken(str, COMMA_SEPARATOR, [&](const char* first, const char* last)
     {
+        // Trim surrounding spaces from the token.
+        while (first != last && *first == ' ')
+        {
+            first++;
+        }
+        while (first != last && *(last - 1) == ' ')
+        {
+            last--;
+        }
+
         typename T::value_type val;
-        stringToData(trimSpaces(token), val);
+        if constexpr (std::is_arithmetic<typename T::value_type>::value &&
+                      !std::is_same<typename T::value_type, bool>::value)
+        {
+            tokenToData(first, last, val);
+        }
+        else
+        {
+            stringToData(string(first, last), val);
+        }
         data.push_back(val);
-    }
+    });
 }
 
+// The dataToString functions append the string representation of the given
+// data to the given string.
 template <class T> void dataToString(const T& data, string& str)
 {
-    std::stringstream ss;
-    ss.imbue(std::locale::classic());
-
-    // Set float format and precision for the stream
-    const Value::FloatFormat fmt = Value::getFloatFormat();
-    ss.setf(std::ios_base::fmtflags(
-            (fmt == Value::FloatFormatFixed ? std::ios_base::fixed :
-            (fmt == Value::FloatFormatScientific ? std::ios_base::scientific : 0))),
-        std::ios_base::floatfield);
-    ss.precision(Value::getFloatPrecision());
-
-    ss << data;
-    str = ss.str();
+    appendNumber(data, str);
 }
 
 template <> void dataToString(const bool& data, string& str)
 {
-    str = data ? VALUE_STRING_TRUE : VALUE_STRING_FALSE;
+    str += data ? VALUE_STRING_TRUE : VALUE_STRING_FALSE;
 }
 
 template <> void dataToString(const string& data, string& str)
 {
-    str = data;
+    str += data;
 }
 
 template <class T> void dataToString(const enable_if_mx_vector_t<T>& data, string& str)
 {
     for (size_t i = 0; i < data.numElements(); i++)
     {
-        string token;
-        dataToString(data[i], token);
-        str += token;
+        appendNumber(data[i], str);
         if (i + 1 < data.numElements())
         {
             str += ARRAY_PREFERRED_SEPARATOR;
@@ -142,9 +256,7 @@ template <class T> void dataToString(const enable_if_mx_matrix_t<T>& data, strin
     {
         for (size_t j = 0; j < data.numColumns(); j++)
         {
-            string token;
-            dataToString(data[i][j], token);
-            str += token;
+            appendNumber(data[i][j], str);
             if (i + 1 < data.numRows() ||
                 j + 1 < data.numColumns())
             {
@@ -158,9 +270,7 @@ template <class T> void dataToString(const enable_if_std_vector_t<T>& data, stri
 {
     for (size_t i = 0; i < data.size(); i++)
     {
-        string token;
-        dataToString<typename T::value_type>(data[i], token);
-        str += token;
+        dataToString<typename T::value_type>(data[i], str);
         if (i + 1 < data.size())
         {
             str += ARRAY_PREFERRED_SEPARATOR;
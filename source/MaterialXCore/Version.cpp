@@ -688,11 +688,12 @@ void Document::upgradeVersion()
             if (materialNode)
             {
                 materialNode->setName(mat->getName());
-                for (const string& attr : mat->getAttributeNames())
+                for (size_t i = 0; i < mat->getAttributeCount(); i++)
                 {
+                    const string& attr = mat->getAttributeName(i);
                     if (!materialNode->hasAttribute(attr))
                     {
-                        materialNode->setAttribute(attr, mat->getAttribute(attr));
+                        materialNode->setAttribute(attr, mat->getAttributeValue(i));
                     }
                 }
             }
@@ -0,0 +1,465 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXFormat/BinaryIo.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+MATERIALX_NAMESPACE_BEGIN
+
+const string MTLX_BINARY_EXTENSION = "mtlxb";
+
+namespace
+{
+
+// A binary document is laid out as a header, followed by the string offset
+// table, the element records in depth-first order, the attribute records in
+// element order, and finally the string data.  All integers are stored in
+// the byte order of the writing machine, which is recorded in the header.
+
+const char BINARY_MAGIC[8] = { 'M', 'T', 'L', 'X', 'B', 'I', 'N', '\0' };
+const uint32_t BINARY_VERSION = 1;
+const uint32_t BINARY_BYTE_ORDER = 0x01020304;
+
+struct BinaryHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t stringCount;
+    uint32_t elementCount;
+    uint32_t attributeCount;
+    uint32_t stringDataSize;
+};
+
+struct ElementRecord
+{
+    uint32_t category;
+    uint32_t name;
+    uint32_t sourceUri;
+    uint32_t attributeCount;
+    uint32_t childCount;
+};
+
+struct AttributeRecord
+{
+    uint32_t name;
+    uint32_t value;
+};
+
+class BinaryWriter
+{
+  public:
+    explicit BinaryWriter(const BinaryWriteOptions* writeOptions) :
+        _elementPredicate(writeOptions ? writeOptions->elementPredicate : nullptr)
+    {
+        // Reserve the first string for the empty string.
+        addString(EMPTY_STRING);
+    }
+
+    void addElement(ConstElementPtr elem)
+    {
+        size_t index = _elements.size();
+        ElementRecord record;
+        record.category = addString(elem->getCategory());
+        record.name = addString(elem->getName());
+        record.sourceUri = addString(elem->getSourceUri());
+        record.attributeCount = 0;
+        record.childCount = 0;
+        for (size_t i = 0; i < elem->getAttributeCount(); i++)
+        {
+            _attributes.push_back({ addString(elem->getAttributeName(i)), addString(elem->getAttributeValue(i)) });
+            record.attributeCount++;
+        }
+        _elements.push_back(record);
+
+        for (const ElementPtr& child : elem->getChildren())
+        {
+            if (_elementPredicate && !_elementPredicate(child))
+            {
+                continue;
+            }
+            _elements[index].childCount++;
+            addElement(child);
+        }
+    }
+
+    void write(std::ostream& stream) const
+    {
+        if (_stringData.size() > UINT32_MAX || _elements.size() > UINT32_MAX || _attributes.size() > UINT32_MAX)
+        {
+            throw Exception("Document is too large for the binary format");
+        }
+
+        BinaryHeader header;
+        std::memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+        header.version = BINARY_VERSION;
+        header.byteOrder = BINARY_BYTE_ORDER;
+        header.stringCount = (uint32_t) (_stringOffsets.size() - 1);
+        header.elementCount = (uint32_t) _elements.size();
+        header.attributeCount = (uint32_t) _attributes.size();
+        header.stringDataSize = (uint32_t) _stringData.size();
+
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        stream.write(reinterpret_cast<const char*>(_stringOffsets.data()), _stringOffsets.size() * sizeof(uint32_t));
+        stream.write(reinterpret_cast<const char*>(_elements.data()), _elements.size() * sizeof(ElementRecord));
+        stream.write(reinterpret_cast<const char*>(_attributes.data()), _attributes.size() * sizeof(AttributeRecord));
+        stream.write(_stringData.data(), _stringData.size());
+    }
+
+  private:
+    uint32_t addString(const string& str)
+    {
+        auto it = _stringIndices.find(str);
+        if (it != _stringIndices.end())
+        {
+            return it->second;
+        }
+        uint32_t index = (uint32_t) _stringIndices.size();
+        _stringIndices.emplace(str, index);
+        _stringData += str;
+        _stringOffsets.push_back((uint32_t) _stringData.size());
+        return index;
+    }
+
+  private:
+    ElementPredicate _elementPredicate;
+    std::unordered_map<string, uint32_t> _stringIndices;
+    vector<uint32_t> _stringOffsets = { 0 };
+    string _stringData;
+    vector<ElementRecord> _elements;
+    vector<AttributeRecord> _attributes;
+};
+
+class BinaryReader
+{
+  public:
+    BinaryReader(const char* buffer, size_t size) :
+        _buffer(buffer),
+        _elementIndex(0),
+        _attributeIndex(0)
+    {
+        if (!buffer || size < sizeof(BinaryHeader))
+        {
+            throw ExceptionParseError("Binary document is truncated");
+        }
+        std::memcpy(&_header, buffer, sizeof(_header));
+        if (std::memcmp(_header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0)
+        {
+            throw ExceptionParseError("Buffer is not a binary MaterialX document");
+        }
+        if (_header.version != BINARY_VERSION)
+        {
+            throw ExceptionParseError("Unsupported binary document version: " + std::to_string(_header.version));
+        }
+        if (_header.byteOrder != BINARY_BYTE_ORDER)
+        {
+            throw ExceptionParseError("Binary document was written with a different byte order");
+        }
+
+        // Locate and bounds-check each table.
+        _stringOffsets = sizeof(BinaryHeader);
+        _elementRecords = _stringOffsets + ((size_t) _header.stringCount + 1) * sizeof(uint32_t);
+        _attributeRecords = _elementRecords + (size_t) _header.elementCount * sizeof(ElementRecord);
+        _stringData = _attributeRecords + (size_t) _header.attributeCount * sizeof(AttributeRecord);
+        if (_stringData + _header.stringDataSize > size || _header.stringCount == 0 || _header.elementCount == 0)
+        {
+            throw ExceptionParseError("Binary document is truncated");
+        }
+
+        // Construct each string of the string table once.
+        _strings.reserve(_header.stringCount);
+        uint32_t begin = readRecord<uint32_t>(_stringOffsets);
+        for (uint32_t i = 1; i <= _header.stringCount; i++)
+        {
+            uint32_t end = readRecord<uint32_t>(_stringOffsets + i * sizeof(uint32_t));
+            if (end < begin || end > _header.stringDataSize)
+            {
+                throw ExceptionParseError("Binary document has an invalid string table");
+            }
+            _strings.emplace_back(buffer + _stringData + begin, end - begin);
+            begin = end;
+        }
+    }
+
+    void read(DocumentPtr doc)
+    {
+        ElementRecord record = nextElement();
+        if (getString(record.category) != Document::CATEGORY)
+        {
+            throw ExceptionParseError("Binary document has an invalid root element");
+        }
+        if (record.sourceUri)
+        {
+            doc->setSourceUri(getString(record.sourceUri));
+        }
+        readContent(doc, record);
+    }
+
+  private:
+    template <class T> T readRecord(size_t offset) const
+    {
+        T record;
+        std::memcpy(&record, _buffer + offset, sizeof(T));
+        return record;
+    }
+
+    const string& getString(uint32_t index) const
+    {
+        if (index >= _strings.size())
+        {
+            throw ExceptionParseError("Binary document has an invalid string index");
+        }
+        return _strings[index];
+    }
+
+    ElementRecord nextElement()
+    {
+        if (_elementIndex >= _header.elementCount)
+        {
+            throw ExceptionParseError("Binary document has an invalid element count");
+        }
+        return readRecord<ElementRecord>(_elementRecords + _elementIndex++ * sizeof(ElementRecord));
+    }
+
+    AttributeRecord nextAttribute()
+    {
+        if (_attributeIndex >= _header.attributeCount)
+        {
+            throw ExceptionParseError("Binary document has an invalid attribute count");
+        }
+        return readRecord<AttributeRecord>(_attributeRecords + _attributeIndex++ * sizeof(AttributeRecord));
+    }
+
+    void readContent(ElementPtr elem, const ElementRecord& record)
+    {
+        // Store attributes in element.
+        for (uint32_t i = 0; i < record.attributeCount; i++)
+        {
+            AttributeRecord attr = nextAttribute();
+            elem->setAttribute(getString(attr.name), getString(attr.value));
+        }
+
+        // Create child elements and recurse.
+        for (uint32_t i = 0; i < record.childCount; i++)
+        {
+            ElementRecord childRecord = nextElement();
+            const string& name = getString(childRecord.name);
+
+            // Check for duplicate elements.
+            if (elem->getChild(name))
+            {
+                skipContent(childRecord);
+                continue;
+            }
+
+            ElementPtr child = elem->addChildOfCategory(getString(childRecord.category), name);
+            if (childRecord.sourceUri)
+            {
+                child->setSourceUri(getString(childRecord.sourceUri));
+            }
+            readContent(child, childRecord);
+        }
+    }
+
+    void skipContent(const ElementRecord& record)
+    {
+        for (uint32_t i = 0; i < record.attributeCount; i++)
+        {
+            nextAttribute();
+        }
+        for (uint32_t i = 0; i < record.childCount; i++)
+        {
+            skipContent(nextElement());
+        }
+    }
+
+  private:
+    const char* _buffer;
+    BinaryHeader _header;
+    size_t _stringOffsets;
+    size_t _elementRecords;
+    size_t _attributeRecords;
+    size_t _stringData;
+    size_t _elementIndex;
+    size_t _attributeIndex;
+    StringVec _strings;
+};
+
+// A read-only mapping of a file into memory.
+class MappedFile
+{
+  public:
+    explicit MappedFile(const FilePath& filename) :
+        _data(nullptr),
+        _size(0)
+    {
+        string path = filename.asString();
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw ExceptionFileMissing("Failed to open file for reading: " + path);
+        }
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+        {
+            HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (mapping)
+            {
+                _data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                _size = _data ? (size_t) fileSize.QuadPart : 0;
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+#else
+        int file = open(path.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            throw ExceptionFileMissing("Failed to open file for reading: " + path);
+        }
+        struct stat sb;
+        if (fstat(file, &sb) == 0 && sb.st_size > 0)
+        {
+            void* data = mmap(nullptr, (size_t) sb.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (data != MAP_FAILED)
+            {
+                _data = static_cast<const char*>(data);
+                _size = (size_t) sb.st_size;
+            }
+        }
+        close(file);
+#endif
+    }
+
+    ~MappedFile()
+    {
+        if (_data)
+        {
+#if defined(_WIN32)
+            UnmapViewOfFile(_data);
+#else
+            munmap(const_cast<char*>(_data), _size);
+#endif
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* getData() const
+    {
+        return _data;
+    }
+
+    size_t getSize() const
+    {
+        return _size;
+    }
+
+  private:
+    const char* _data;
+    size_t _size;
+};
+
+} // anonymous namespace
+
+//
+// BinaryReadOptions methods
+//
+
+BinaryReadOptions::BinaryReadOptions() :
+    upgradeVersion(true)
+{
+}
+
+//
+// BinaryWriteOptions methods
+//
+
+BinaryWriteOptions::BinaryWriteOptions()
+{
+}
+
+//
+// Reading
+//
+
+void readFromBinaryBuffer(DocumentPtr doc, const char* buffer, size_t size, const BinaryReadOptions* readOptions)
+{
+    // Report the content of the document to observers as a single change.
+    ScopedTransaction transaction(doc);
+
+    BinaryReader reader(buffer, size);
+    reader.read(doc);
+
+    if (!readOptions || readOptions->upgradeVersion)
+    {
+        doc->upgradeVersion();
+    }
+}
+
+void readFromBinaryFile(DocumentPtr doc, FilePath filename, FileSearchPath searchPath, const BinaryReadOptions* readOptions)
+{
+    searchPath.append(getEnvironmentPath());
+    filename = searchPath.find(filename);
+
+    MappedFile file(filename);
+    if (!file.getData())
+    {
+        throw ExceptionParseError("Binary document is truncated in " + filename.asString());
+    }
+
+    // Documents that were not read from a file take the binary filename as
+    // their source URI, matching the behavior of readFromXmlFile.
+    doc->setSourceUri(filename);
+    readFromBinaryBuffer(doc, file.getData(), file.getSize(), readOptions);
+}
+
+void readFromBinaryString(DocumentPtr doc, const string& str, const BinaryReadOptions* readOptions)
+{
+    readFromBinaryBuffer(doc, str.data(), str.size(), readOptions);
+}
+
+//
+// Writing
+//
+
+void writeToBinaryStream(DocumentPtr doc, std::ostream& stream, const BinaryWriteOptions* writeOptions)
+{
+    BinaryWriter writer(writeOptions);
+    writer.addElement(doc);
+    writer.write(stream);
+}
+
+void writeToBinaryFile(DocumentPtr doc, const FilePath& filename, const BinaryWriteOptions* writeOptions)
+{
+    std::ofstream ofs(filename.asString(), std::ios::binary);
+    writeToBinaryStream(doc, ofs, writeOptions);
+}
+
+string writeToBinaryString(DocumentPtr doc, const BinaryWriteOptions* writeOptions)
+{
+    std::ostringstream stream;
+    writeToBinaryStream(doc, stream, writeOptions);
+    return stream.str();
+}
+
+MATERIALX_NAMESPACE_END
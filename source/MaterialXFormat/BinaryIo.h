@@ -0,0 +1,130 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_BINARYIO_H
+#define MATERIALX_BINARYIO_H
+
+/// @file
+/// Support for a binary, memory-mappable MaterialX file format
+///
+/// A binary document stores a string table followed by fixed-size element
+/// and attribute records, allowing documents to be loaded without parsing
+/// text.  Each element records its source URI, so a document that is read
+/// from XML, written as binary, and then written back to XML produces the
+/// same XML output, including its XInclude references.
+
+#include <MaterialXCore/Library.h>
+
+#include <MaterialXCore/Document.h>
+
+#include <MaterialXFormat/Export.h>
+#include <MaterialXFormat/File.h>
+#include <MaterialXFormat/XmlIo.h>
+
+MATERIALX_NAMESPACE_BEGIN
+
+extern MX_FORMAT_API const string MTLX_BINARY_EXTENSION;
+
+/// @class BinaryReadOptions
+/// A set of options for controlling the behavior of binary read functions.
+class MX_FORMAT_API BinaryReadOptions
+{
+  public:
+    BinaryReadOptions();
+    ~BinaryReadOptions() { }
+
+    /// If true, then documents from earlier versions of MaterialX will be upgraded
+    /// to the current version.  Defaults to true.
+    bool upgradeVersion;
+};
+
+/// @class BinaryWriteOptions
+/// A set of options for controlling the behavior of binary write functions.
+class MX_FORMAT_API BinaryWriteOptions
+{
+  public:
+    BinaryWriteOptions();
+    ~BinaryWriteOptions() { }
+
+    /// If provided, this function will be used to exclude specific elements
+    /// (those returning false) from the write operation.  Defaults to nullptr.
+    ElementPredicate elementPredicate;
+};
+
+/// @name Read Functions
+/// @{
+
+/// Read a Document in binary format from the given buffer.
+/// @param doc The Document into which data is read.
+/// @param buffer The buffer from which data is read.
+/// @param size The size of the buffer in bytes.
+/// @param readOptions An optional pointer to a BinaryReadOptions object.
+///    If provided, then the given options will affect the behavior of the
+///    read function.  Defaults to a null pointer.
+/// @throws ExceptionParseError if the document cannot be parsed.
+MX_FORMAT_API void readFromBinaryBuffer(DocumentPtr doc, const char* buffer, size_t size, const BinaryReadOptions* readOptions = nullptr);
+
+/// Read a Document in binary format from the given filename.  The file is
+/// mapped into memory rather than read through a stream.
+/// @param doc The Document into which data is read.
+/// @param filename The filename from which data is read.  This argument can
+///    be supplied either as a FilePath or a standard string.
+/// @param searchPath An optional sequence of file paths that will be applied
+///    in order when searching for the given file.  This argument can be
+///    supplied either as a FileSearchPath, or as a standard string with
+///    paths separated by the PATH_SEPARATOR character.
+/// @param readOptions An optional pointer to a BinaryReadOptions object.
+///    If provided, then the given options will affect the behavior of the
+///    read function.  Defaults to a null pointer.
+/// @throws ExceptionParseError if the document cannot be parsed.
+/// @throws ExceptionFileMissing if the file cannot be opened.
+MX_FORMAT_API void readFromBinaryFile(DocumentPtr doc,
+                                      FilePath filename,
+                                      FileSearchPath searchPath = FileSearchPath(),
+                                      const BinaryReadOptions* readOptions = nullptr);
+
+/// Read a Document in binary format from the given string.
+/// @param doc The Document into which data is read.
+/// @param str The string from which data is read.
+/// @param readOptions An optional pointer to a BinaryReadOptions object.
+///    If provided, then the given options will affect the behavior of the
+///    read function.  Defaults to a null pointer.
+/// @throws ExceptionParseError if the document cannot be parsed.
+MX_FORMAT_API void readFromBinaryString(DocumentPtr doc, const string& str, const BinaryReadOptions* readOptions = nullptr);
+
+/// @}
+/// @name Write Functions
+/// @{
+
+/// Write a Document in binary format to the given output stream.
+/// @param doc The Document to be written.
+/// @param stream The output stream to which data is written.
+/// @param writeOptions An optional pointer to a BinaryWriteOptions object.
+///    If provided, then the given options will affect the behavior of the
+///    write function.  Defaults to a null pointer.
+MX_FORMAT_API void writeToBinaryStream(DocumentPtr doc, std::ostream& stream, const BinaryWriteOptions* writeOptions = nullptr);
+
+/// Write a Document in binary format to the given filename.
+/// @param doc The Document to be written.
+/// @param filename The filename to which data is written.  This argument can
+///    be supplied either as a FilePath or a standard string.
+/// @param writeOptions An optional pointer to a BinaryWriteOptions object.
+///    If provided, then the given options will affect the behavior of the
+///    write function.  Defaults to a null pointer.
+MX_FORMAT_API void writeToBinaryFile(DocumentPtr doc, const FilePath& filename, const BinaryWriteOptions* writeOptions = nullptr);
+
+/// Write a Document in binary format to a new string, returned by value.
+/// @param doc The Document to be written.
+/// @param writeOptions An optional pointer to a BinaryWriteOptions object.
+///    If provided, then the given options will affect the behavior of the
+///    write function.  Defaults to a null pointer.
+/// @return The output string, returned by value
+MX_FORMAT_API string writeToBinaryString(DocumentPtr doc, const BinaryWriteOptions* writeOptions = nullptr);
+
+/// @}
+
+MATERIALX_NAMESPACE_END
+
+#endif
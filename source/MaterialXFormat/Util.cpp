@@ -192,7 +192,7 @@ void flattenFilenames(DocumentPtr doc, const FileSearchPath& searchPath, StringR
     }
 
     // Remove any file prefix attributes
-    for (ElementPtr elem : doc->traverseTree())
+    for (Element* elem : doc->traverseTreeRaw())
     {
         if (elem->hasFilePrefix())
         {
@@ -88,10 +88,10 @@ void elementToXml(ConstElementPtr elem, xml_node& xmlNode, const XmlWriteOptions
     {
         xmlNode.append_attribute(Element::NAME_ATTRIBUTE.c_str()) = elem->getName().c_str();
     }
-    for (const string& attrName : elem->getAttributeNames())
+    for (size_t i = 0; i < elem->getAttributeCount(); i++)
     {
-        xml_attribute xmlAttr = xmlNode.append_attribute(attrName.c_str());
-        xmlAttr.set_value(elem->getAttribute(attrName).c_str());
+        xml_attribute xmlAttr = xmlNode.append_attribute(elem->getAttributeName(i).c_str());
+        xmlAttr.set_value(elem->getAttributeValue(i).c_str());
     }
 
     // Create child nodes and recurse.
@@ -226,6 +226,9 @@ void documentFromXml(DocumentPtr doc,
                      const FileSearchPath& searchPath = FileSearchPath(),
                      const XmlReadOptions* readOptions = nullptr)
 {
+    // Report the content of the document to observers as a single change.
+    ScopedTransaction transaction(doc);
+
     xml_node xmlRoot = xmlDoc.child(Document::CATEGORY.c_str());
     if (xmlRoot)
     {
@@ -429,12 +429,12 @@ void ShaderNode::createMetadata(const NodeDef& nodeDef, GenContext& context)
 
     // Set metadata on the node according to the nodedef attributes.
     ShaderMetadataVecPtr nodeMetadataStorage = getMetadata();
-    for (const string& nodedefAttr : nodeDef.getAttributeNames())
+    for (size_t i = 0; i < nodeDef.getAttributeCount(); i++)
     {
-        const ShaderMetadata* metadataEntry = registry->findMetadata(nodedefAttr);
+        const ShaderMetadata* metadataEntry = registry->findMetadata(nodeDef.getAttributeName(i));
         if (metadataEntry)
         {
-            const string& attrValue = nodeDef.getAttribute(nodedefAttr);
+            const string& attrValue = nodeDef.getAttributeValue(i);
             if (!attrValue.empty())
             {
                 ValuePtr value = Value::createValueFromStrings(attrValue, metadataEntry->type.getName());
@@ -463,12 +463,12 @@ void ShaderNode::createMetadata(const NodeDef& nodeDef, GenContext& context)
         {
             ShaderMetadataVecPtr inputMetadataStorage = input->getMetadata();
 
-            for (const string& nodedefPortAttr : nodedefPort->getAttributeNames())
+            for (size_t i = 0; i < nodedefPort->getAttributeCount(); i++)
             {
-                const ShaderMetadata* metadataEntry = registry->findMetadata(nodedefPortAttr);
+                const ShaderMetadata* metadataEntry = registry->findMetadata(nodedefPort->getAttributeName(i));
                 if (metadataEntry)
                 {
-                    const string& attrValue = nodedefPort->getAttribute(nodedefPortAttr);
+                    const string& attrValue = nodedefPort->getAttributeValue(i);
                     if (!attrValue.empty())
                     {
                         const TypeDesc type = metadataEntry->type != Type::NONE ? metadataEntry->type : input->getType();
@@ -275,6 +275,12 @@ void MeshStream::transform(const Matrix44& matrix)
         getType() == MeshStream::TEXCOORD_ATTRIBUTE ||
         getType() == MeshStream::GEOMETRY_PROPERTY_ATTRIBUTE)
     {
+        if (stride == STRIDE_3D)
+        {
+            Vector3* points = reinterpret_cast<Vector3*>(_data.data());
+            matrix.transformPoints(points, points, numElements);
+            return;
+        }
         for (size_t i = 0; i < numElements; i++)
         {
             Vector4 vec(0.0, 0.0, 0.0, 1.0);
@@ -294,6 +300,23 @@ void MeshStream::transform(const Matrix44& matrix)
              getType() == MeshStream::BITANGENT_ATTRIBUTE)
     {
         bool isNormalStream = (getType() == MeshStream::NORMAL_ATTRIBUTE);
+        if (stride == STRIDE_3D)
+        {
+            Vector3* vectors = reinterpret_cast<Vector3*>(_data.data());
+            if (isNormalStream)
+            {
+                matrix.transformNormals(vectors, vectors, numElements);
+            }
+            else
+            {
+                matrix.transformVectors(vectors, vectors, numElements);
+            }
+            for (size_t i = 0; i < numElements; i++)
+            {
+                vectors[i] = vectors[i].getNormalized();
+            }
+            return;
+        }
         Matrix44 transformMatrix = isNormalStream ? matrix.getInverse().getTranspose() : matrix;
 
         for (size_t i = 0; i < numElements; i++)
@@ -10,8 +10,43 @@
 #include <MaterialXFormat/Util.h>
 #include <MaterialXFormat/XmlIo.h>
 
+#include <thread>
+
 namespace mx = MaterialX;
 
+namespace
+{
+
+class RecordingObserver : public mx::DocumentObserver
+{
+  public:
+    void onChanges(mx::DocumentPtr, const mx::DocumentChangeVec& changes) override
+    {
+        batches.push_back(changes);
+        if (throwOnChanges)
+        {
+            throw mx::Exception("Observer failure");
+        }
+    }
+
+    std::vector<mx::DocumentChangeVec> batches;
+    bool throwOnChanges = false;
+};
+
+class QueryingObserver : public mx::DocumentObserver
+{
+  public:
+    void onChanges(mx::DocumentPtr doc, const mx::DocumentChangeVec&) override
+    {
+        matchCounts.push_back(doc->getMatchingNodeDefs(nodeString).size());
+    }
+
+    std::string nodeString;
+    std::vector<size_t> matchCounts;
+};
+
+} // anonymous namespace
+
 TEST_CASE("Document", "[document]")
 {
     // Create a document.
@@ -116,3 +151,1013 @@ TEST_CASE("Document", "[document]")
     // Validate the combined document.
     REQUIRE(doc->validate());
 }
+
+TEST_CASE("Document cache", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    // Compare the incrementally maintained cache against a full rebuild.
+    auto cacheMatchesRebuild = [doc](const std::string& nodeName, const std::string& nodeDefName)
+    {
+        std::vector<mx::NodeDefPtr> nodeDefs = doc->getMatchingNodeDefs(nodeName);
+        std::vector<mx::PortElementPtr> ports = doc->getMatchingPorts(nodeName);
+        std::vector<mx::InterfaceElementPtr> impls = doc->getMatchingImplementations(nodeDefName);
+        doc->invalidateCache();
+        std::set<mx::NodeDefPtr> nodeDefSet(nodeDefs.begin(), nodeDefs.end());
+        std::set<mx::PortElementPtr> portSet(ports.begin(), ports.end());
+        std::set<mx::InterfaceElementPtr> implSet(impls.begin(), impls.end());
+        std::vector<mx::NodeDefPtr> rebuiltNodeDefs = doc->getMatchingNodeDefs(nodeName);
+        std::vector<mx::PortElementPtr> rebuiltPorts = doc->getMatchingPorts(nodeName);
+        std::vector<mx::InterfaceElementPtr> rebuiltImpls = doc->getMatchingImplementations(nodeDefName);
+        return nodeDefs.size() == rebuiltNodeDefs.size() &&
+               ports.size() == rebuiltPorts.size() &&
+               impls.size() == rebuiltImpls.size() &&
+               nodeDefSet == std::set<mx::NodeDefPtr>(rebuiltNodeDefs.begin(), rebuiltNodeDefs.end()) &&
+               portSet == std::set<mx::PortElementPtr>(rebuiltPorts.begin(), rebuiltPorts.end()) &&
+               implSet == std::set<mx::InterfaceElementPtr>(rebuiltImpls.begin(), rebuiltImpls.end());
+    };
+
+    // Create a definition, implementation and instance.
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_custom", "color3", "custom");
+    mx::ImplementationPtr impl = doc->addImplementation("IM_custom");
+    impl->setNodeDef(nodeDef);
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("graph1");
+    mx::NodePtr node = nodeGraph->addNode("custom", "custom1", "color3");
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(node);
+    REQUIRE(doc->getMatchingNodeDefs("custom").size() == 1);
+    REQUIRE(doc->getMatchingPorts("custom1").size() == 1);
+    REQUIRE(doc->getMatchingImplementations("ND_custom").size() == 1);
+    REQUIRE(node->getNodeDef() == nodeDef);
+
+    // Edit attributes with a valid cache.
+    nodeDef->setNodeString("custom2");
+    REQUIRE(doc->getMatchingNodeDefs("custom").empty());
+    REQUIRE(doc->getMatchingNodeDefs("custom2").size() == 1);
+    REQUIRE(cacheMatchesRebuild("custom2", "ND_custom"));
+    nodeDef->setNodeString("custom");
+    output->setNodeName("custom2");
+    REQUIRE(doc->getMatchingPorts("custom1").empty());
+    REQUIRE(doc->getMatchingPorts("custom2").size() == 1);
+    output->removeAttribute(mx::PortElement::NODE_NAME_ATTRIBUTE);
+    REQUIRE(doc->getMatchingPorts("custom2").empty());
+    output->setConnectedNode(node);
+    REQUIRE(cacheMatchesRebuild("custom1", "ND_custom"));
+
+    // Add and remove elements with a valid cache.
+    mx::NodeDefPtr nodeDef2 = doc->addNodeDef("ND_custom2", "float", "custom");
+    REQUIRE(doc->getMatchingNodeDefs("custom").size() == 2);
+    mx::NodeGraphPtr copiedGraph = doc->addNodeGraph("graph2");
+    copiedGraph->copyContentFrom(nodeGraph);
+    REQUIRE(doc->getMatchingPorts("custom1").size() == 2);
+    REQUIRE(cacheMatchesRebuild("custom1", "ND_custom"));
+    doc->removeNodeGraph("graph2");
+    REQUIRE(doc->getMatchingPorts("custom1").size() == 1);
+    doc->removeNodeDef("ND_custom2");
+    REQUIRE(doc->getMatchingNodeDefs("custom").size() == 1);
+    REQUIRE(cacheMatchesRebuild("custom", "ND_custom"));
+
+    // Edits to removed elements should not affect the cache.
+    doc->removeNodeGraph("graph2");
+    nodeDef2->setNodeString("custom");
+    REQUIRE(doc->getMatchingNodeDefs("custom").size() == 1);
+
+    // Implementations referencing nodegraphs by name.
+    mx::ImplementationPtr graphImpl = doc->addImplementation("IM_custom_graph");
+    graphImpl->setNodeDef(nodeDef);
+    graphImpl->setNodeGraph("NG_custom");
+    REQUIRE(doc->getMatchingImplementations("ND_custom").size() == 1);
+    mx::NodeGraphPtr implGraph = doc->addNodeGraph("NG_custom");
+    REQUIRE(doc->getMatchingImplementations("ND_custom").size() == 2);
+    implGraph->setName("NG_custom_renamed");
+    REQUIRE(doc->getMatchingImplementations("ND_custom").size() == 1);
+    implGraph->setName("NG_custom");
+    REQUIRE(cacheMatchesRebuild("custom", "ND_custom"));
+    doc->removeNodeGraph("NG_custom");
+    REQUIRE(doc->getMatchingImplementations("ND_custom").size() == 1);
+
+    // Namespace edits.
+    nodeGraph->setNamespace("ns");
+    REQUIRE(doc->getMatchingPorts("ns:custom1").size() == 1);
+    REQUIRE(cacheMatchesRebuild("ns:custom1", "ND_custom"));
+
+    // Clear the document content.
+    nodeGraph->clearContent();
+    REQUIRE(doc->getMatchingPorts("custom1").empty());
+    REQUIRE(doc->getMatchingPorts("ns:custom1").empty());
+    REQUIRE(cacheMatchesRebuild("custom", "ND_custom"));
+}
+
+TEST_CASE("Document cache threading", "[document]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, doc);
+
+    // Add a graph of connected nodes.
+    mx::NodeGraphPtr graph = doc->addNodeGraph("graph1");
+    const size_t NODE_COUNT = 64;
+    std::vector<mx::NodePtr> nodes;
+    for (size_t i = 0; i < NODE_COUNT; i++)
+    {
+        mx::NodePtr node = graph->addNode("add", "add" + std::to_string(i), "float");
+        if (!nodes.empty())
+        {
+            node->setConnectedNode("in1", nodes.back());
+            node->setConnectedNode("in2", nodes.front());
+        }
+        nodes.push_back(node);
+    }
+
+    // Compute reference results serially.
+    mx::StringVec categories;
+    std::vector<size_t> expectedCounts;
+    for (mx::NodeDefPtr nodeDef : doc->getNodeDefs())
+    {
+        categories.push_back(nodeDef->getNodeString());
+    }
+    for (const std::string& category : categories)
+    {
+        expectedCounts.push_back(doc->getMatchingNodeDefs(category).size());
+    }
+    mx::NodeDefPtr expectedNodeDef = doc->getNodeDef("ND_add_float");
+    REQUIRE(expectedNodeDef);
+    std::vector<size_t> expectedPortCounts;
+    for (mx::NodePtr node : nodes)
+    {
+        expectedPortCounts.push_back(node->getDownstreamPorts().size());
+    }
+    REQUIRE(expectedPortCounts.front() == NODE_COUNT);
+
+    // Query the document from many threads, starting from both a valid and
+    // an invalidated cache.
+    const size_t THREAD_COUNT = 8;
+    for (bool invalidate : { false, true })
+    {
+        if (invalidate)
+        {
+            doc->invalidateCache();
+        }
+        std::vector<size_t> mismatches(THREAD_COUNT, 0);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < THREAD_COUNT; t++)
+        {
+            threads.emplace_back([&, t]()
+            {
+                for (size_t i = 0; i < categories.size(); i++)
+                {
+                    size_t index = (i + t * 7) % categories.size();
+                    if (doc->getMatchingNodeDefs(categories[index]).size() != expectedCounts[index])
+                    {
+                        mismatches[t]++;
+                    }
+                }
+                for (size_t i = 0; i < nodes.size(); i++)
+                {
+                    size_t index = (i + t * 7) % nodes.size();
+                    if (nodes[index]->getNodeDef() != expectedNodeDef)
+                    {
+                        mismatches[t]++;
+                    }
+                    if (nodes[index]->getDownstreamPorts().size() != expectedPortCounts[index])
+                    {
+                        mismatches[t]++;
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        for (size_t mismatch : mismatches)
+        {
+            REQUIRE(mismatch == 0);
+        }
+    }
+}
+
+TEST_CASE("Document memory arena", "[document]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr heapDoc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, heapDoc);
+
+    // Load the same content into a document backed by a memory arena.
+    mx::MemoryArenaPtr arena = mx::MemoryArena::create();
+    mx::DocumentPtr arenaDoc = mx::createDocument();
+    arenaDoc->setMemoryArena(arena);
+    REQUIRE(arenaDoc->getMemoryArena() == arena);
+    mx::loadLibraries({ "libraries" }, searchPath, arenaDoc);
+    REQUIRE(arena->getReservedSize() > 0);
+    REQUIRE(*arenaDoc == *heapDoc);
+    REQUIRE(arenaDoc->validate());
+
+    // Over-aligned and oversized requests are served with their alignment.
+    for (size_t alignment : { alignof(std::max_align_t), (size_t) 64, (size_t) 4096 })
+    {
+        for (size_t size : { (size_t) 8, (size_t) 100000 })
+        {
+            void* ptr = arena->allocate(size, alignment);
+            REQUIRE(reinterpret_cast<uintptr_t>(ptr) % alignment == 0);
+            arena->deallocate(ptr, size, alignment);
+        }
+    }
+
+    // Edit the arena document, recycling the storage of removed elements.
+    mx::NodeGraphPtr nodeGraph = arenaDoc->addNodeGraph();
+    for (int i = 0; i < 100; i++)
+    {
+        mx::NodePtr node = nodeGraph->addNode("multiply", mx::EMPTY_STRING, "color3");
+        node->setInputValue("in2", mx::Color3(0.5f));
+        nodeGraph->removeNode(node->getName());
+    }
+    arenaDoc->removeNodeGraph(nodeGraph->getName());
+    nodeGraph = nullptr;
+    REQUIRE(*arenaDoc == *heapDoc);
+
+    // Verify that elements remain valid beyond the lifetime of their document.
+    mx::NodeDefPtr nodeDef = arenaDoc->getNodeDefs()[0];
+    std::string nodeDefName = nodeDef->getName();
+    std::string nodeString = nodeDef->getNodeString();
+    std::weak_ptr<mx::MemoryArena> weakArena = arena;
+    arena = nullptr;
+    arenaDoc = nullptr;
+    REQUIRE(!weakArena.expired());
+    REQUIRE(nodeDef->getName() == nodeDefName);
+    REQUIRE(nodeDef->getNodeString() == nodeString);
+    nodeDef = nullptr;
+    REQUIRE(weakArena.expired());
+
+    // Load and edit content with an unsynchronized arena.
+    arena = mx::MemoryArena::create(mx::MemoryArena::DEFAULT_BLOCK_SIZE, false);
+    REQUIRE(!arena->isThreadSafe());
+    arenaDoc = mx::createDocument();
+    arenaDoc->setMemoryArena(arena);
+    mx::loadLibraries({ "libraries" }, searchPath, arenaDoc);
+    REQUIRE(*arenaDoc == *heapDoc);
+    arenaDoc->removeNodeDef(arenaDoc->getNodeDefs()[0]->getName());
+    REQUIRE(*arenaDoc != *heapDoc);
+}
+
+TEST_CASE("Frozen document", "[document]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, doc);
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("graph1");
+    mx::NodePtr constant = nodeGraph->addNode("constant", "constant1", "color3");
+    mx::NodePtr multiply = nodeGraph->addNode("multiply", "multiply1", "color3");
+    multiply->setConnectedNode("in1", constant);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(multiply);
+
+    // Freeze the document.
+    REQUIRE(!doc->isFrozen());
+    doc->freeze();
+    REQUIRE(doc->isFrozen());
+    REQUIRE(doc->validate());
+
+    // Verify that mutators throw.
+    REQUIRE_THROWS_AS(doc->addNodeGraph(), mx::ExceptionFrozenDocument);
+    REQUIRE_THROWS_AS(doc->removeNodeGraph("graph1"), mx::ExceptionFrozenDocument);
+    REQUIRE_THROWS_AS(multiply->setName("multiply2"), mx::ExceptionFrozenDocument);
+    REQUIRE_THROWS_AS(multiply->setCategory("add"), mx::ExceptionFrozenDocument);
+    REQUIRE_THROWS_AS(multiply->setInputValue("in2", mx::Color3(0.5f)), mx::ExceptionFrozenDocument);
+    REQUIRE_THROWS_AS(multiply->removeAttribute(mx::TypedElement::TYPE_ATTRIBUTE), mx::ExceptionFrozenDocument);
+    REQUIRE_THROWS_AS(doc->setMemoryArena(mx::MemoryArena::create()), mx::ExceptionFrozenDocument);
+    REQUIRE_THROWS_AS(doc->initialize(), mx::ExceptionFrozenDocument);
+    REQUIRE(multiply->getName() == "multiply1");
+    REQUIRE(multiply->getType() == "color3");
+    REQUIRE(nodeGraph->getNodes().size() == 2);
+
+    // Invalidating the cache of a frozen document has no effect.
+    doc->invalidateCache();
+    REQUIRE(multiply->getNodeDef());
+
+    // Compute reference results serially.
+    std::vector<mx::ElementPtr> elements;
+    std::vector<mx::ConstNodeDefPtr> expectedNodeDefs;
+    mx::StringVec expectedNamePaths;
+    for (mx::ElementPtr elem : doc->traverseTree())
+    {
+        mx::NodePtr node = elem->asA<mx::Node>();
+        elements.push_back(elem);
+        expectedNodeDefs.push_back(node ? node->getNodeDef() : nullptr);
+        expectedNamePaths.push_back(elem->getNamePath());
+    }
+
+    // Query the frozen document from many threads.
+    const size_t THREAD_COUNT = 8;
+    std::vector<size_t> mismatches(THREAD_COUNT, 0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREAD_COUNT; t++)
+    {
+        threads.emplace_back([&, t]()
+        {
+            for (size_t i = 0; i < elements.size(); i++)
+            {
+                size_t index = (i + t * 31) % elements.size();
+                mx::ConstElementPtr elem = elements[index];
+                mx::ConstNodePtr node = elem->asA<mx::Node>();
+                if ((node ? node->getNodeDef() : nullptr) != expectedNodeDefs[index] ||
+                    elem->getNamePath() != expectedNamePaths[index] ||
+                    doc->getDescendant(expectedNamePaths[index]) != elem)
+                {
+                    mismatches[t]++;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    for (size_t mismatch : mismatches)
+    {
+        REQUIRE(mismatch == 0);
+    }
+
+    // A copy of a frozen document is mutable.
+    mx::DocumentPtr copy = doc->copy();
+    REQUIRE(!copy->isFrozen());
+    REQUIRE(*copy == *doc);
+    copy->removeNodeGraph("graph1");
+    REQUIRE(*copy != *doc);
+}
+
+TEST_CASE("Document data library", "[document]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr library = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, library);
+    library->freeze();
+
+    mx::FilePath examplePath("resources/Materials/Examples/StandardSurface/standard_surface_brick_procedural.mtlx");
+
+    // Create a reference document with an imported copy of the library.
+    mx::DocumentPtr importDoc = mx::createDocument();
+    mx::readFromXmlFile(importDoc, examplePath, searchPath);
+    importDoc->importLibrary(library);
+
+    // Create a document referencing the library as a data library.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, examplePath, searchPath);
+    size_t childCount = doc->getChildren().size();
+    REQUIRE(!doc->hasDataLibrary());
+    doc->setDataLibrary(library);
+    REQUIRE(doc->hasDataLibrary());
+    REQUIRE(doc->getDataLibrary() == library);
+    REQUIRE(doc->getChildren().size() == childCount);
+    REQUIRE(doc->getNodeDefs().empty());
+    REQUIRE(doc->validate());
+
+    // Definition lookups fall through to the data library.
+    REQUIRE(doc->getNodeDef("ND_standard_surface_surfaceshader") == library->getNodeDef("ND_standard_surface_surfaceshader"));
+    REQUIRE(doc->getTypeDef("color3") == library->getTypeDef("color3"));
+    REQUIRE(doc->getImplementation("IM_image_color3_genglsl") == library->getImplementation("IM_image_color3_genglsl"));
+    REQUIRE(doc->getNodeGraph("NG_tiledimage_color3") == library->getNodeGraph("NG_tiledimage_color3"));
+    REQUIRE(doc->getMatchingNodeDefs("image").size() == library->getMatchingNodeDefs("image").size());
+    REQUIRE(!doc->getNodeDef("ND_unknown"));
+
+    // Nodes resolve to equivalent definitions in both documents.
+    for (mx::ElementPtr elem : doc->traverseTree())
+    {
+        mx::NodePtr node = elem->asA<mx::Node>();
+        if (!node)
+        {
+            continue;
+        }
+        mx::NodePtr importNode = importDoc->getDescendant(node->getNamePath())->asA<mx::Node>();
+        REQUIRE(importNode);
+        mx::NodeDefPtr nodeDef = node->getNodeDef();
+        REQUIRE(nodeDef);
+        REQUIRE(nodeDef->getDocument() == library);
+        REQUIRE(nodeDef->getName() == importNode->getNodeDef()->getName());
+        REQUIRE(node->getType() == importNode->getType());
+        REQUIRE(node->getTypeDef() == library->getTypeDef(node->getType()));
+        REQUIRE(nodeDef->getImplementation());
+    }
+
+    // Local definitions take precedence over those in the data library.
+    mx::NodeDefPtr localNodeDef = doc->addNodeDef("ND_image_color3", "color3", "image");
+    REQUIRE(doc->getNodeDef("ND_image_color3") == localNodeDef);
+    REQUIRE(doc->getMatchingNodeDefs("image")[0] == localNodeDef);
+    doc->removeNodeDef("ND_image_color3");
+
+    // Copies reference the same data library.
+    mx::DocumentPtr copy = doc->copy();
+    REQUIRE(copy->getDataLibrary() == library);
+
+    // Data library cycles are rejected.
+    mx::DocumentPtr cycleLibrary = mx::createDocument();
+    cycleLibrary->setDataLibrary(doc);
+    REQUIRE_THROWS(doc->setDataLibrary(cycleLibrary));
+    REQUIRE(doc->getDataLibrary() == library);
+
+    // Remove the data library.
+    doc->setDataLibrary(nullptr);
+    REQUIRE(!doc->hasDataLibrary());
+    REQUIRE(!doc->getNodeDef("ND_standard_surface_surfaceshader"));
+}
+
+TEST_CASE("Document parallel validation", "[document]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, doc);
+
+    // Introduce errors in several top-level elements.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_invalid");
+    mx::NodePtr node = nodeGraph->addNode("unknown_node", "node1", "float");
+    node->setConnectedNode("in", nodeGraph->addNode("constant", "node2", "color3"));
+    doc->addNodeDef("ND_invalid", "float", "")->setVersionString("1.0");
+    doc->addOutput("out")->setNodeName("missing");
+
+    // Verify that parallel validation matches serial validation.
+    std::string serialMessage;
+    bool serialResult = doc->validate(&serialMessage);
+    REQUIRE(!serialResult);
+    REQUIRE(!serialMessage.empty());
+    for (unsigned int threadCount : { 0u, 1u, 2u, 3u, 8u })
+    {
+        std::string parallelMessage;
+        REQUIRE(doc->validate(&parallelMessage, threadCount) == serialResult);
+        REQUIRE(parallelMessage == serialMessage);
+    }
+
+    // Verify a valid document.
+    doc->removeNodeGraph(nodeGraph->getName());
+    doc->removeNodeDef("ND_invalid");
+    doc->removeOutput("out");
+    std::string message;
+    REQUIRE(doc->validate(&message, 4));
+    REQUIRE(message.empty());
+}
+
+TEST_CASE("Document incremental validation", "[document]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr library = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, library);
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, "resources/Materials/Examples/StandardSurface/standard_surface_brick_procedural.mtlx", searchPath);
+    doc->setDataLibrary(library);
+
+    // Verify that retained results match the validation of a fresh copy.
+    auto validateIncrementally = [doc](bool expected)
+    {
+        std::string message, expectedMessage;
+        bool res = doc->validate(&message);
+        REQUIRE(doc->copy()->validate(&expectedMessage) == res);
+        REQUIRE(message == expectedMessage);
+        REQUIRE(res == expected);
+    };
+    validateIncrementally(true);
+
+    // Edit the content of a nodegraph.
+    mx::NodeGraphPtr nodeGraph = doc->getNodeGraphs()[0];
+    mx::NodePtr node = nodeGraph->getNodes()[0];
+    mx::InputPtr input = node->getInputs()[0];
+    std::string type = input->getType();
+    input->setType("filename");
+    validateIncrementally(false);
+    input->setType(type);
+    validateIncrementally(true);
+
+    // Break and restore a connection to the nodegraph from a top-level node.
+    std::string graphName = nodeGraph->getName();
+    nodeGraph->setName("renamed_graph");
+    validateIncrementally(false);
+    nodeGraph->setName(graphName);
+    validateIncrementally(true);
+
+    // Add and remove an invalid top-level node.
+    mx::NodePtr invalidNode = doc->addNode("image", "invalid_image", "color3");
+    invalidNode->setInputValue("file", 1.0f);
+    validateIncrementally(false);
+    doc->removeNode(invalidNode->getName());
+    validateIncrementally(true);
+
+    // Request a node version that is declared only by a local nodedef.
+    mx::NodePtr shader = doc->getNodes()[0];
+    shader->setVersionString("2.0");
+    validateIncrementally(false);
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_custom", shader->getType(), shader->getCategory());
+    nodeDef->setVersionString("2.0");
+    for (mx::InputPtr shaderInput : shader->getInputs())
+    {
+        nodeDef->addInput(shaderInput->getName(), shaderInput->getType());
+    }
+    validateIncrementally(true);
+    doc->removeNodeDef(nodeDef->getName());
+    validateIncrementally(false);
+    shader->removeAttribute(mx::InterfaceElement::VERSION_ATTRIBUTE);
+    validateIncrementally(true);
+
+    // Remove a top-level node that another top-level node inherits from.
+    mx::NodePtr baseNode = doc->addNode("constant", "inherit_base", "color3");
+    mx::NodePtr derivedNode = doc->addNode("constant", "inherit_derived", "color3");
+    derivedNode->setInheritString(baseNode->getName());
+    validateIncrementally(true);
+    doc->removeNode(baseNode->getName());
+    validateIncrementally(false);
+    doc->removeNode(derivedNode->getName());
+    validateIncrementally(true);
+
+    // Edit a definition within the data library.
+    mx::NodeDefPtr libraryNodeDef = shader->getNodeDef();
+    REQUIRE(libraryNodeDef);
+    libraryNodeDef->getActiveInput(shader->getInputs()[0]->getName())->setType("filename");
+    validateIncrementally(false);
+    doc->setDataLibrary(nullptr);
+    validateIncrementally(true);
+
+    // Create and break a cycle upstream of a top-level output.
+    mx::NodePtr nodeA = doc->addNode("add", "cycle_a", "color3");
+    mx::NodePtr nodeB = doc->addNode("add", "cycle_b", "color3");
+    nodeA->setConnectedNode("in1", nodeB);
+    mx::OutputPtr cycleOutput = doc->addOutput("cycle_out", "color3");
+    cycleOutput->setConnectedNode(nodeA);
+    validateIncrementally(true);
+    nodeB->setConnectedNode("in1", nodeA);
+    validateIncrementally(false);
+    std::string message;
+    doc->validate(&message);
+    REQUIRE(message.find("Cycle in upstream path") != std::string::npos);
+    nodeB->setConnectedNode("in1", nullptr);
+    nodeB->setInputValue("in1", mx::Color3(0.0f));
+    validateIncrementally(true);
+}
+
+TEST_CASE("Document observers", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    auto observer = std::make_shared<RecordingObserver>();
+    doc->addObserver(observer);
+
+    // Changes outside of a transaction are reported individually.
+    mx::NodePtr constant = doc->addNode("constant", "constant1", "color3");
+    REQUIRE(observer->batches.size() == 3);
+    const mx::DocumentChange& addChange = observer->batches[0][0];
+    REQUIRE(addChange.getType() == mx::DocumentChange::TypeAddElement);
+    REQUIRE(addChange.getElement() == constant);
+    REQUIRE(addChange.getParent() == doc);
+    const mx::DocumentChange& categoryChange = observer->batches[1][0];
+    REQUIRE(categoryChange.getType() == mx::DocumentChange::TypeAttribute);
+    REQUIRE(categoryChange.getName().empty());
+    const mx::DocumentChange& typeChange = observer->batches[2][0];
+    REQUIRE(typeChange.getType() == mx::DocumentChange::TypeAttribute);
+    REQUIRE(typeChange.getName() == mx::TypedElement::TYPE_ATTRIBUTE);
+    observer->batches.clear();
+
+    constant->setName("constant2");
+    REQUIRE(observer->batches.size() == 1);
+    REQUIRE(observer->batches[0][0].getType() == mx::DocumentChange::TypeRenameElement);
+    REQUIRE(observer->batches[0][0].getName() == "constant1");
+    observer->batches.clear();
+
+    // Changes within a transaction are coalesced and reported together.
+    mx::NodePtr image = doc->addNode("image", "image1", "color3");
+    observer->batches.clear();
+    doc->beginTransaction();
+    mx::NodeGraphPtr graph = doc->addNodeGraph("graph1");
+    graph->addNode("add", "add1", "color3")->setInputValue("in1", mx::Color3(1.0f));
+    graph->setAttribute("doc", "A graph");
+    constant->setInputValue("value", mx::Color3(0.1f));
+    constant->setInputValue("value", mx::Color3(0.2f));
+    {
+        mx::ScopedTransaction transaction(doc);
+        doc->setChildIndex(image->getName(), 0);
+        doc->removeNode(image->getName());
+    }
+    REQUIRE(doc->isInTransaction());
+    REQUIRE(observer->batches.empty());
+    doc->endTransaction();
+    REQUIRE(!doc->isInTransaction());
+    REQUIRE(observer->batches.size() == 1);
+
+    const mx::DocumentChangeVec& changes = observer->batches[0];
+    REQUIRE(changes.size() == 4);
+    REQUIRE(changes[0].getType() == mx::DocumentChange::TypeAddElement);
+    REQUIRE(changes[0].getElement() == graph);
+    REQUIRE(changes[1].getType() == mx::DocumentChange::TypeAddElement);
+    REQUIRE(changes[1].getElement() == constant->getInput("value"));
+    REQUIRE(changes[1].getParent() == constant);
+    REQUIRE(changes[2].getType() == mx::DocumentChange::TypeChildOrder);
+    REQUIRE(changes[2].getElement() == doc);
+    REQUIRE(changes[3].getType() == mx::DocumentChange::TypeRemoveElement);
+    REQUIRE(changes[3].getElement() == image);
+    REQUIRE(changes[3].getParent() == doc);
+    observer->batches.clear();
+
+    // Repeated attribute changes are reported once per transaction.
+    {
+        mx::ScopedTransaction transaction(doc);
+        constant->getInput("value")->setValue(mx::Color3(0.3f));
+        constant->getInput("value")->setValue(mx::Color3(0.4f));
+        constant->getInput("value")->removeAttribute(mx::ValueElement::VALUE_ATTRIBUTE);
+    }
+    REQUIRE(observer->batches.size() == 1);
+    REQUIRE(observer->batches[0].size() == 2);
+    REQUIRE(observer->batches[0][0].getName() == mx::TypedElement::TYPE_ATTRIBUTE);
+    REQUIRE(observer->batches[0][1].getName() == mx::ValueElement::VALUE_ATTRIBUTE);
+    observer->batches.clear();
+
+    // Library imports are reported as a single batch of top-level additions.
+    mx::DocumentPtr library = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), library);
+    doc->importLibrary(library);
+    REQUIRE(observer->batches.size() == 1);
+    REQUIRE(observer->batches[0].size() == library->getChildren().size());
+    for (const mx::DocumentChange& change : observer->batches[0])
+    {
+        REQUIRE(change.getType() == mx::DocumentChange::TypeAddElement);
+        REQUIRE(change.getParent() == doc);
+    }
+    observer->batches.clear();
+
+    // Unbalanced transactions are rejected.
+    REQUIRE_THROWS_AS(doc->endTransaction(), mx::Exception);
+
+    // Scoped transactions that exit by an exception still report their
+    // changes, which remain in the document.
+    try
+    {
+        mx::ScopedTransaction transaction(doc);
+        doc->addNode("constant", "constant_unwind", "float");
+        throw mx::Exception("Edit failure");
+    }
+    catch (mx::Exception&)
+    {
+    }
+    REQUIRE(!doc->isInTransaction());
+    REQUIRE(observer->batches.size() == 1);
+    REQUIRE(observer->batches[0][0].getElement() == doc->getNode("constant_unwind"));
+    observer->batches.clear();
+
+    // Scoped transactions tolerate explicit ends and failing observers.
+    {
+        mx::ScopedTransaction transaction(doc);
+        doc->endTransaction();
+    }
+    REQUIRE(!doc->isInTransaction());
+    {
+        mx::ScopedTransaction outer(doc);
+        {
+            mx::ScopedTransaction inner(doc);
+            REQUIRE(doc->getTransactionDepth() == 2);
+            doc->endTransaction();
+        }
+        REQUIRE(doc->getTransactionDepth() == 1);
+        doc->addNode("constant", "constant_nested", "float");
+        REQUIRE(observer->batches.empty());
+    }
+    REQUIRE(!doc->isInTransaction());
+    REQUIRE(observer->batches.size() == 1);
+    REQUIRE(observer->batches[0][0].getElement() == doc->getNode("constant_nested"));
+    observer->batches.clear();
+    observer->throwOnChanges = true;
+    {
+        mx::ScopedTransaction transaction(doc);
+        doc->removeNode("constant_unwind");
+    }
+    REQUIRE(!doc->isInTransaction());
+    REQUIRE(observer->batches.size() == 1);
+    observer->throwOnChanges = false;
+    observer->batches.clear();
+
+    // Observers that are removed receive no further changes.
+    doc->removeObserver(observer);
+    doc->addNode("constant", "constant3", "float");
+    REQUIRE(observer->batches.empty());
+}
+
+TEST_CASE("Document observer queries", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_custom", "float", "custom");
+    auto observer = std::make_shared<QueryingObserver>();
+    observer->nodeString = "foo";
+    doc->addObserver(observer);
+
+    // Observers that query the document see the completed edit, and their
+    // queries leave cached data consistent with the document.
+    doc->invalidateCache();
+    nodeDef->setNodeString("foo");
+    REQUIRE(observer->matchCounts == std::vector<size_t>{ 1 });
+    REQUIRE(doc->getMatchingNodeDefs("foo").size() == 1);
+    nodeDef->setNodeString("bar");
+    REQUIRE(observer->matchCounts == std::vector<size_t>{ 1, 0 });
+    REQUIRE(doc->getMatchingNodeDefs("foo").empty());
+    REQUIRE(doc->getMatchingNodeDefs("bar").size() == 1);
+    observer->matchCounts.clear();
+
+    // Additions and removals are reported once the document reflects them.
+    observer->nodeString = "bar";
+    doc->invalidateCache();
+    mx::NodeDefPtr nodeDef2 = doc->addNodeDef("ND_custom2", "float", "bar");
+    REQUIRE(observer->matchCounts.back() == 2);
+    observer->matchCounts.clear();
+    doc->invalidateCache();
+    doc->removeNodeDef(nodeDef2->getName());
+    REQUIRE(observer->matchCounts == std::vector<size_t>{ 1 });
+    REQUIRE(doc->getMatchingNodeDefs("bar").size() == 1);
+    observer->matchCounts.clear();
+    doc->invalidateCache();
+    doc->clearContent();
+    REQUIRE(!observer->matchCounts.empty());
+    for (size_t count : observer->matchCounts)
+    {
+        REQUIRE(count == 0);
+    }
+    REQUIRE(doc->getMatchingNodeDefs("bar").empty());
+}
+
+TEST_CASE("Document name path index", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries/stdlib" }, mx::getDefaultDataSearchPath(), doc);
+    mx::NodeGraphPtr graph = doc->addNodeGraph("graph1");
+    mx::NodePtr image = graph->addNode("image", "image1", "color3");
+    mx::InputPtr file = image->addInput("file", mx::FILENAME_TYPE_STRING);
+
+    // Verify that indexed lookups agree with traversal of the document.
+    auto verifyIndex = [&doc]()
+    {
+        for (mx::ElementPtr elem : doc->traverseTree())
+        {
+            if (elem == doc)
+            {
+                continue;
+            }
+            const std::string namePath = elem->getNamePath();
+            REQUIRE(doc->getDescendant(namePath) == elem);
+            mx::ElementPtr parent = elem->getParent();
+            REQUIRE(parent->getDescendant(elem->getName()) == elem);
+            REQUIRE(elem->getNamePath(parent) == elem->getName());
+        }
+    };
+    REQUIRE(!doc->getNamePathIndexing());
+    doc->setNamePathIndexing(true);
+    REQUIRE(doc->getNamePathIndexing());
+    verifyIndex();
+    REQUIRE(doc->getDescendant("graph1/image1/file") == file);
+    REQUIRE(graph->getDescendant("image1/file") == file);
+    REQUIRE(doc->getDescendant("/graph1//image1/file/") == file);
+    REQUIRE(file->getNamePath(graph) == "image1/file");
+    REQUIRE(!doc->getDescendant("graph1/image2"));
+
+    // Verify that the index tracks edits to the document.
+    graph->setName("graph2");
+    image->addInput("uaddressmode", mx::STRING_TYPE_STRING);
+    graph->removeNode("image1");
+    mx::NodePtr constant = graph->addNode("constant", "image1", "color3");
+    verifyIndex();
+    REQUIRE(doc->getDescendant("graph2/image1") == constant);
+    REQUIRE(!doc->getDescendant("graph2/image1/file"));
+    REQUIRE(!doc->getDescendant("graph1"));
+    REQUIRE(image->getDescendant("file") == file);
+
+    // Verify that copies and imported content are indexed.
+    mx::DocumentPtr copy = doc->copy();
+    copy->setNamePathIndexing(true);
+    REQUIRE(copy->getDescendant("graph2/image1")->getParent() == copy->getNodeGraph("graph2"));
+    mx::DocumentPtr imported = mx::createDocument();
+    imported->setNamePathIndexing(true);
+    imported->importLibrary(doc);
+    REQUIRE(imported->getDescendant("graph2/image1")->getNamePath() == "graph2/image1");
+
+    // Disable the index.
+    doc->setNamePathIndexing(false);
+    REQUIRE(doc->getDescendant("graph2/image1") == constant);
+}
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Document cache performance", "[document]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    // Interleave graph edits with nodedef lookups, with and without the
+    // standard libraries present.  The cost of each iteration should not
+    // depend on the size of the document.
+    for (bool importLibraries : { false, true })
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        if (importLibraries)
+        {
+            doc->importLibrary(libraries);
+        }
+        mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+        mx::NodePtr image = nodeGraph->addNode("image", "image1", "color3");
+        mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+
+        BENCHMARK(importLibraries ? "Edit and lookup with libraries" : "Edit and lookup without libraries")
+        {
+            mx::NodePtr node = nodeGraph->addNode("multiply", mx::EMPTY_STRING, "color3");
+            node->setConnectedNode("in1", image);
+            output->setConnectedNode(node);
+            mx::NodeDefPtr nodeDef = node->getNodeDef();
+            nodeGraph->removeNode(node->getName());
+            return nodeDef;
+        };
+    }
+}
+
+TEST_CASE("Document cache threading performance", "[document]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, doc);
+
+    mx::StringVec categories;
+    for (mx::NodeDefPtr nodeDef : doc->getNodeDefs())
+    {
+        categories.push_back(nodeDef->getNodeString());
+    }
+
+    // Measure lookup throughput with concurrent readers of a shared document.
+    size_t threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    BENCHMARK("Concurrent nodedef lookups")
+    {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back([&]()
+            {
+                for (const std::string& category : categories)
+                {
+                    doc->getMatchingNodeDefs(category);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        return threadCount;
+    };
+}
+
+TEST_CASE("Document memory arena performance", "[document]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+
+    // Measure the cost of loading and destroying the standard libraries,
+    // with elements allocated from the system heap, from a synchronized
+    // memory arena, and from an unsynchronized memory arena.
+    const std::vector<std::pair<std::string, int>> modes =
+    {
+        { "Load and destroy libraries without arena", 0 },
+        { "Load and destroy libraries with arena", 1 },
+        { "Load and destroy libraries with unsynchronized arena", 2 }
+    };
+    for (const auto& mode : modes)
+    {
+        BENCHMARK(mode.first.c_str())
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            if (mode.second)
+            {
+                doc->setMemoryArena(mx::MemoryArena::create(mx::MemoryArena::DEFAULT_BLOCK_SIZE, mode.second == 1));
+            }
+            mx::loadLibraries({ "libraries" }, searchPath, doc);
+            return doc->getChildren().size();
+        };
+    }
+}
+
+TEST_CASE("Document data library performance", "[document]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr library = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, library);
+    library->freeze();
+
+    mx::DocumentPtr material = mx::createDocument();
+    mx::readFromXmlFile(material, "resources/Materials/Examples/StandardSurface/standard_surface_brick_procedural.mtlx", searchPath);
+
+    // Measure the cost of preparing many material documents that share the
+    // same library, either by importing or by referencing the library.
+    const size_t DOCUMENT_COUNT = 100;
+    for (bool useDataLibrary : { false, true })
+    {
+        BENCHMARK(useDataLibrary ? "Reference library in 100 documents" : "Import library into 100 documents")
+        {
+            std::vector<mx::DocumentPtr> docs;
+            for (size_t i = 0; i < DOCUMENT_COUNT; i++)
+            {
+                mx::DocumentPtr doc = material->copy();
+                if (useDataLibrary)
+                {
+                    doc->setDataLibrary(library);
+                }
+                else
+                {
+                    doc->importLibrary(library);
+                }
+                docs.push_back(doc);
+            }
+            return docs.size();
+        };
+    }
+}
+
+TEST_CASE("Node definition resolution performance", "[document]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    // Load the example documents, and gather the nodes within them.
+    std::vector<mx::DocumentPtr> docs;
+    mx::StringVec errors;
+    mx::loadDocuments(searchPath.find("resources/Materials/Examples"), searchPath, {}, {}, docs, errors);
+    std::vector<mx::NodePtr> nodes;
+    for (mx::DocumentPtr doc : docs)
+    {
+        doc->importLibrary(libraries);
+        for (mx::ElementPtr elem : doc->traverseTree())
+        {
+            mx::NodePtr node = elem->asA<mx::Node>();
+            if (node)
+            {
+                nodes.push_back(node);
+            }
+        }
+    }
+
+    // Resolve every example node, alternating between shading language
+    // targets as a shader generator would.
+    BENCHMARK("Resolve example nodes")
+    {
+        size_t resolved = 0;
+        for (mx::NodePtr node : nodes)
+        {
+            resolved += node->getNodeDef() != nullptr;
+            resolved += node->getNodeDef("genglsl") != nullptr;
+        }
+        return resolved;
+    };
+}
+
+TEST_CASE("Document name path index performance", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), doc);
+    std::vector<mx::ElementPtr> elems;
+    mx::StringVec namePaths;
+    for (mx::ElementPtr elem : doc->traverseTree())
+    {
+        if (elem != doc)
+        {
+            elems.push_back(elem);
+            namePaths.push_back(elem->getNamePath());
+        }
+    }
+
+    for (bool indexing : { false, true })
+    {
+        doc->setNamePathIndexing(indexing);
+        std::string suffix = indexing ? " with index" : " without index";
+
+        BENCHMARK("Look up descendants" + suffix)
+        {
+            size_t count = 0;
+            for (const std::string& namePath : namePaths)
+            {
+                count += doc->getDescendant(namePath) != nullptr;
+            }
+            return count;
+        };
+
+        BENCHMARK("Compute name paths" + suffix)
+        {
+            size_t length = 0;
+            for (mx::ElementPtr elem : elems)
+            {
+                length += elem->getNamePath().size();
+            }
+            return length;
+        };
+    }
+}
+
+TEST_CASE("Document parallel validation performance", "[document]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, doc);
+
+    // Measure the scaling of validation across thread counts.
+    for (unsigned int threadCount : { 1u, 2u, 4u, 8u })
+    {
+        BENCHMARK("Validate libraries with " + std::to_string(threadCount) + " threads")
+        {
+            return doc->validate(nullptr, threadCount);
+        };
+    }
+}
+#endif
@@ -6,6 +6,8 @@
 #include <MaterialXTest/External/Catch/catch.hpp>
 
 #include <MaterialXCore/Document.h>
+#include <MaterialXFormat/Util.h>
+#include <MaterialXFormat/XmlIo.h>
 
 namespace mx = MaterialX;
 
@@ -47,6 +49,33 @@ TEST_CASE("Element", "[element]")
     REQUIRE(elem2->getName() == "elem2");
     REQUIRE_THROWS_AS(elem2->setName("elem1"), mx::Exception);
 
+    // Create unique child names, matching repeated application of incrementName.
+    auto incrementChildName = [](mx::ElementPtr parent, std::string name)
+    {
+        while (parent->getChild(name))
+        {
+            name = mx::incrementName(name);
+        }
+        return name;
+    };
+    mx::ElementPtr group = doc->addChildOfCategory("group");
+    for (int i = 0; i < 20; i++)
+    {
+        group->addChildOfCategory("generic", group->createValidChildName("item1"));
+    }
+    group->addChildOfCategory("generic", "item22");
+    group->removeChild("item7");
+    group->getChild("item12")->setName("item012");
+    for (const char* name : { "item", "item1", "item5", "item9", "item012", "item21", "item99", "_" })
+    {
+        REQUIRE(group->createValidChildName(name) == incrementChildName(group, name));
+        group->addChildOfCategory("generic", group->createValidChildName(name));
+    }
+    REQUIRE(group->getChild("item7"));
+    REQUIRE(group->getChild("item12"));
+    REQUIRE(group->getChild("item23"));
+    doc->removeChild(group->getName());
+
     // Modify element order.
     mx::DocumentPtr doc2 = doc->copy();
     REQUIRE(*doc2 == *doc);
@@ -69,3 +98,168 @@ TEST_CASE("Element", "[element]")
     }
     REQUIRE_THROWS_AS(orphan->getDocument(), mx::ExceptionOrphanedElement);
 }
+
+TEST_CASE("Content hashing", "[element]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::InputPtr graphInput = nodeGraph->addInput("scale", "float");
+    graphInput->setValue(2.0f);
+    mx::NodePtr constant = nodeGraph->addNode("constant", "constant1", "color3");
+    constant->setInputValue("value", mx::Color3(0.5f));
+    mx::NodePtr multiply = nodeGraph->addNode("multiply", "multiply1", "color3");
+    multiply->setConnectedNode("in1", constant);
+    multiply->addInput("in2", "float")->setInterfaceName("scale");
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(multiply);
+
+    // Equal documents have equal hashes.
+    mx::DocumentPtr doc2 = doc->copy();
+    REQUIRE(*doc2 == *doc);
+    REQUIRE(doc2->getContentHash() == doc->getContentHash());
+    REQUIRE(doc2->getUpstreamHash() == doc->getUpstreamHash());
+
+    // Hashes are independent of attribute order.
+    mx::ElementPtr elem1 = doc->addChildOfCategory("generic", "elem1");
+    elem1->setAttribute("a", "1");
+    elem1->setAttribute("b", "2");
+    mx::ElementPtr elem2 = doc2->addChildOfCategory("generic", "elem1");
+    elem2->setAttribute("b", "2");
+    elem2->setAttribute("a", "1");
+    REQUIRE(elem1->getContentHash() == elem2->getContentHash());
+    REQUIRE(doc->getContentHash() == doc2->getContentHash());
+
+    // Attributes with standard and custom names are stored in order, and
+    // copies of custom names are independent of their source.
+    mx::ElementPtr attrElem = doc->addChildOfCategory("generic", "attrElem");
+    attrElem->setAttribute("customAttribute", "1");
+    attrElem->setAttribute(mx::Element::DOC_ATTRIBUTE, "2");
+    REQUIRE(attrElem->getAttributeCount() == 2);
+    REQUIRE(attrElem->getAttributeName(0) == "customAttribute");
+    REQUIRE(attrElem->getAttributeValue(0) == "1");
+    REQUIRE(attrElem->getAttributeName(1) == mx::Element::DOC_ATTRIBUTE);
+    REQUIRE(attrElem->getAttributeNames() == mx::StringVec{ "customAttribute", mx::Element::DOC_ATTRIBUTE });
+
+    // Standard names match through any attribute constant or string with
+    // the same name, and never match custom names.
+    attrElem->setAttribute(mx::PortElement::NODE_GRAPH_ATTRIBUTE, "graph1");
+    REQUIRE(attrElem->getAttribute(mx::Implementation::NODE_GRAPH_ATTRIBUTE) == "graph1");
+    REQUIRE(attrElem->getAttribute(std::string("nodegraph")) == "graph1");
+    attrElem->setAttribute("nodegraph", "graph2");
+    REQUIRE(attrElem->getAttributeCount() == 3);
+    REQUIRE(attrElem->getAttribute(mx::PortElement::NODE_GRAPH_ATTRIBUTE) == "graph2");
+    REQUIRE(!attrElem->hasAttribute("customattribute"));
+    attrElem->removeAttribute(mx::Implementation::NODE_GRAPH_ATTRIBUTE);
+    REQUIRE(attrElem->getAttributeCount() == 2);
+    mx::ElementPtr attrCopy = doc2->addChildOfCategory("generic", "attrElem");
+    attrCopy->copyContentFrom(attrElem);
+    REQUIRE(*attrCopy == *attrElem);
+    doc->removeChild(attrElem->getName());
+    attrElem = nullptr;
+    REQUIRE(attrCopy->getAttribute("customAttribute") == "1");
+    doc2->removeChild(attrCopy->getName());
+    REQUIRE(doc->getContentHash() == doc2->getContentHash());
+
+    // Edits invalidate the hashes of the edited element and its ancestors.
+    uint64_t docHash = doc->getContentHash();
+    uint64_t graphHash = nodeGraph->getContentHash();
+    uint64_t outputHash = output->getContentHash();
+    constant->setInputValue("value", mx::Color3(0.25f));
+    REQUIRE(doc->getContentHash() != docHash);
+    REQUIRE(nodeGraph->getContentHash() != graphHash);
+    REQUIRE(output->getContentHash() == outputHash);
+    REQUIRE(*doc != *doc2);
+    constant->setInputValue("value", mx::Color3(0.5f));
+    REQUIRE(doc->getContentHash() == docHash);
+    elem1->setName("elem2");
+    REQUIRE(doc->getContentHash() != docHash);
+    elem1->setName("elem1");
+    REQUIRE(doc->getContentHash() == docHash);
+    doc->setChildIndex("elem1", 0);
+    REQUIRE(doc->getContentHash() != docHash);
+    doc->setChildIndex("elem1", 1);
+    REQUIRE(doc->getContentHash() == docHash);
+    doc->removeChild("elem1");
+    REQUIRE(doc->getContentHash() != docHash);
+    doc2->removeChild("elem1");
+    REQUIRE(doc->getContentHash() == doc2->getContentHash());
+
+    // Presentation attributes and comments may be excluded from hashes.
+    docHash = doc->getContentHash();
+    uint64_t uiFreeDocHash = doc->getContentHash(true);
+    multiply->setAttribute(mx::Element::XPOS_ATTRIBUTE, "3.5");
+    graphInput->setAttribute(mx::ValueElement::UI_NAME_ATTRIBUTE, "Scale");
+    nodeGraph->addChildOfCategory(mx::CommentElement::CATEGORY)->setDocString("A comment");
+    REQUIRE(doc->getContentHash() != docHash);
+    REQUIRE(doc->getContentHash(true) == uiFreeDocHash);
+    graphInput->setValue(3.0f);
+    REQUIRE(doc->getContentHash(true) != uiFreeDocHash);
+    graphInput->setValue(2.0f);
+
+    // Upstream hashes reflect the values of upstream nodes and interface
+    // inputs, but not of unrelated elements.
+    uint64_t upstreamHash = output->getUpstreamHash();
+    REQUIRE(upstreamHash != output->getContentHash());
+    constant->setInputValue("value", mx::Color3(0.25f));
+    REQUIRE(output->getUpstreamHash() != upstreamHash);
+    constant->setInputValue("value", mx::Color3(0.5f));
+    REQUIRE(output->getUpstreamHash() == upstreamHash);
+    graphInput->setValue(3.0f);
+    REQUIRE(output->getUpstreamHash() != upstreamHash);
+    graphInput->setValue(2.0f);
+    REQUIRE(output->getUpstreamHash() == upstreamHash);
+    nodeGraph->addNode("constant", "unconnected", "float");
+    REQUIRE(output->getUpstreamHash() == upstreamHash);
+
+    // Upstream hashes with and without presentation attributes are cached
+    // independently, and reflect edits to connections.
+    uint64_t uiFreeUpstreamHash = output->getUpstreamHash(true);
+    REQUIRE(uiFreeUpstreamHash != upstreamHash);
+    REQUIRE(output->getUpstreamHash() == upstreamHash);
+    REQUIRE(output->getUpstreamHash(true) == uiFreeUpstreamHash);
+    multiply->setAttribute(mx::Element::XPOS_ATTRIBUTE, "4.5");
+    REQUIRE(output->getUpstreamHash() != upstreamHash);
+    REQUIRE(output->getUpstreamHash(true) == uiFreeUpstreamHash);
+    multiply->setAttribute(mx::Element::XPOS_ATTRIBUTE, "3.5");
+    output->setConnectedNode(constant);
+    REQUIRE(output->getUpstreamHash() != upstreamHash);
+    output->setConnectedNode(multiply);
+    REQUIRE(output->getUpstreamHash() == upstreamHash);
+}
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Content hashing performance", "[element]")
+{
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), libraries);
+    mx::DocumentPtr doc = libraries->copy();
+    mx::NodeDefPtr nodeDef = doc->getNodeDef("ND_image_color3");
+    int counter = 0;
+
+    BENCHMARK("Compare edited libraries by XML string")
+    {
+        nodeDef->setDocString(std::to_string(counter++));
+        return mx::writeToXmlString(doc) == mx::writeToXmlString(libraries);
+    };
+
+    BENCHMARK("Compare edited libraries by content hash")
+    {
+        nodeDef->setDocString(std::to_string(counter++));
+        return doc->getContentHash() == libraries->getContentHash();
+    };
+}
+
+TEST_CASE("Child naming performance", "[element]")
+{
+    BENCHMARK("Add 100k nodes with automatic names")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+        for (int i = 0; i < 100000; i++)
+        {
+            nodeGraph->addNode("image");
+        }
+        return doc;
+    };
+}
+#endif
@@ -37,6 +37,31 @@ TEST_CASE("Geom strings", "[geom]")
     // Test that one path contains another.
     REQUIRE(mx::geomStringsMatch("/", "/robot1", true));
     REQUIRE(!mx::geomStringsMatch("/robot1", "/", true));
+
+    // Test that precompiled matchers agree with geometry string comparisons.
+    mx::StringVec queryStrings =
+    {
+        "",
+        "/",
+        "/robot1",
+        "/robot2",
+        "/robot1/left_arm/hand",
+        "/robot2, /robot3",
+        "robot2/left_arm"
+    };
+    geomStrings.push_back("/robot1, /robot2/left_arm");
+    for (const std::string& geomString : geomStrings)
+    {
+        for (bool contains : { false, true })
+        {
+            mx::GeomMatcher matcher(geomString, contains);
+            for (const std::string& queryString : queryStrings)
+            {
+                REQUIRE(matcher.matchesGeomString(queryString) == mx::geomStringsMatch(geomString, queryString, contains));
+            }
+        }
+    }
+    REQUIRE(!mx::GeomMatcher().matchesGeomString("/"));
 }
 
 TEST_CASE("Geom elements", "[geom]")
@@ -88,9 +113,17 @@ TEST_CASE("Geom elements", "[geom]")
     REQUIRE(collection2->matchesGeomString("/scene1/sphere1"));
     REQUIRE(!collection2->matchesGeomString("/scene1/sphere2"));
 
+    // Test a precompiled matcher for the derived collection.
+    mx::GeomMatcher matcher(collection2);
+    REQUIRE(matcher.matchesGeomString("/scene1/sphere1"));
+    REQUIRE(matcher.matchesGeomString("/scene1"));
+    REQUIRE(!matcher.matchesGeomString("/scene1/sphere2/mesh"));
+    REQUIRE(!matcher.matchesGeomString("/scene2"));
+
     // Create and test an include cycle.
     collection1->setIncludeCollection(collection2);
     REQUIRE(!doc->validate());
+    REQUIRE_THROWS_AS(mx::GeomMatcher{ collection1 }, mx::ExceptionFoundCycle);
     collection1->setIncludeCollection(nullptr);
     REQUIRE(doc->validate());
 
@@ -100,6 +133,47 @@ TEST_CASE("Geom elements", "[geom]")
     REQUIRE(!collection1->matchesGeomString("/root/scene2"));
 }
 
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Geom matching performance", "[geom]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::CollectionPtr base = doc->addCollection("base");
+    base->setIncludeGeom("/scene/character, /scene/props/chair, /scene/props/table");
+    base->setExcludeGeom("/scene/character/hair");
+    mx::CollectionPtr derived = doc->addCollection("derived");
+    derived->setIncludeGeom("/scene/set/wall");
+    derived->setIncludeCollection(base);
+
+    mx::StringVec geomStrings;
+    const mx::StringVec groups = { "character", "character/hair", "props/chair", "props/lamp", "set/wall", "set/floor" };
+    for (int i = 0; i < 10000; i++)
+    {
+        geomStrings.push_back("/scene/" + groups[i % groups.size()] + "/mesh" + std::to_string(i));
+    }
+
+    BENCHMARK("Match collection by element")
+    {
+        size_t count = 0;
+        for (const std::string& geom : geomStrings)
+        {
+            count += derived->matchesGeomString(geom);
+        }
+        return count;
+    };
+
+    BENCHMARK("Match collection by precompiled matcher")
+    {
+        mx::GeomMatcher matcher(derived);
+        size_t count = 0;
+        for (const std::string& geom : geomStrings)
+        {
+            count += matcher.matchesGeomString(geom);
+        }
+        return count;
+    };
+}
+#endif
+
 TEST_CASE("GeomPropDef", "[geom]")
 {
     mx::DocumentPtr doc = mx::createDocument();
@@ -121,3 +121,159 @@ TEST_CASE("LookGroup", "[look]")
     lookGroups = doc->getLookGroups();
     REQUIRE(lookGroups.size() == 0);
 }
+
+TEST_CASE("Look resolver", "[look]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodePtr shaderNode = doc->addNode("standard_surface", "", mx::SURFACE_SHADER_TYPE_STRING);
+    mx::NodePtr materialNode = doc->addMaterialNode("", shaderNode);
+
+    // Create a base look with geometry and collection assignments.
+    mx::LookPtr baseLook = doc->addLook("baseLook");
+    mx::CollectionPtr collection = doc->addCollection("arms");
+    collection->setIncludeGeom("/robot1/arm, /robot2/arm");
+    collection->setExcludeGeom("/robot2/arm/hand");
+    mx::MaterialAssignPtr matAssign1 = baseLook->addMaterialAssign("matAssign1", materialNode->getName());
+    matAssign1->setGeom("/robot1, /robot3");
+    mx::MaterialAssignPtr matAssign2 = baseLook->addMaterialAssign("matAssign2", materialNode->getName());
+    matAssign2->setCollection(collection);
+    matAssign2->addVariantAssign("variantAssign1");
+    mx::PropertyAssignPtr propertyAssign = baseLook->addPropertyAssign("propertyAssign");
+    propertyAssign->setGeom("/robot1/arm");
+    mx::VisibilityPtr visibility = baseLook->addVisibility("visibility");
+    visibility->setCollection(collection);
+
+    // Create a derived look with its own assignments.
+    mx::LookPtr look = doc->addLook("look");
+    look->setInheritsFrom(baseLook);
+    mx::MaterialAssignPtr matAssign3 = look->addMaterialAssign("matAssign3", materialNode->getName());
+    matAssign3->setGeom("/");
+    mx::PropertySetAssignPtr propertySetAssign = look->addPropertySetAssign("propertySetAssign");
+    propertySetAssign->setGeom("/robot2");
+    mx::VariantAssignPtr variantAssign2 = look->addVariantAssign("variantAssign2");
+
+    // Verify resolved assignments against direct matching of each element.
+    mx::StringVec geoms = { "", "/", "/robot1", "/robot1/arm/hand", "/robot2/arm", "/robot2/arm/hand", "/robot3, /robot4", "/robot4" };
+    mx::LookResolver resolver(look);
+    std::vector<mx::GeomAssignments> results = resolver.resolve(geoms, 2);
+    REQUIRE(results.size() == geoms.size());
+    for (size_t i = 0; i < geoms.size(); i++)
+    {
+        const std::string& geom = geoms[i];
+        std::vector<mx::MaterialAssignPtr> matAssigns;
+        for (mx::MaterialAssignPtr matAssign : look->getActiveMaterialAssigns())
+        {
+            if (mx::geomStringsMatch(matAssign->getActiveGeom(), geom, true) ||
+                (matAssign->getCollection() && matAssign->getCollection()->matchesGeomString(geom)))
+            {
+                matAssigns.push_back(matAssign);
+            }
+        }
+        REQUIRE(results[i].materialAssigns == matAssigns);
+        REQUIRE((results[i].propertyAssigns.size() == 1) == mx::geomStringsMatch("/robot1/arm", geom, true));
+        REQUIRE((results[i].propertySetAssigns.size() == 1) == mx::geomStringsMatch("/robot2", geom, true));
+        REQUIRE((results[i].visibilities.size() == 1) == collection->matchesGeomString(geom));
+        REQUIRE(results[i].variantAssigns.front() == variantAssign2);
+        REQUIRE(results[i].variantAssigns.size() == (collection->matchesGeomString(geom) ? 2 : 1));
+        REQUIRE(resolver.resolve(geom).materialAssigns == matAssigns);
+    }
+    REQUIRE(results[6].materialAssigns == std::vector<mx::MaterialAssignPtr>({ matAssign3, matAssign1 }));
+    REQUIRE(results[4].materialAssigns == std::vector<mx::MaterialAssignPtr>({ matAssign3, matAssign2 }));
+
+    // Resolve the looks of a look group.
+    mx::LookGroupPtr lookGroup = doc->addLookGroup("lookGroup");
+    lookGroup->setLooks("baseLook, look");
+    REQUIRE(mx::LookResolver(lookGroup).resolve("/robot3").materialAssigns.size() == 3);
+    lookGroup->setActiveLook("baseLook");
+    REQUIRE(mx::LookResolver(lookGroup).resolve("/robot3").materialAssigns.size() == 1);
+}
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Look resolver performance", "[look]")
+{
+    // Create a synthetic scene, with material assignments to geometry and
+    // collections at several levels of the hierarchy.
+    const size_t ASSET_COUNT = 100;
+    const size_t PART_COUNT = 10;
+    const size_t MESH_COUNT = 100;
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodePtr shaderNode = doc->addNode("standard_surface", "", mx::SURFACE_SHADER_TYPE_STRING);
+    mx::NodePtr materialNode = doc->addMaterialNode("", shaderNode);
+    mx::LookPtr look = doc->addLook();
+    for (size_t asset = 0; asset < ASSET_COUNT; asset++)
+    {
+        std::string assetPath = "/scene/asset" + std::to_string(asset);
+        look->addMaterialAssign("", materialNode->getName())->setGeom(assetPath + "/part0, " + assetPath + "/part1");
+        look->addPropertyAssign()->setGeom(assetPath);
+        if (asset % 10 == 0)
+        {
+            mx::CollectionPtr collection = doc->addCollection();
+            collection->setIncludeGeom(assetPath);
+            collection->setExcludeGeom(assetPath + "/part2");
+            look->addMaterialAssign("", materialNode->getName())->setCollection(collection);
+        }
+    }
+    mx::StringVec geoms;
+    for (size_t asset = 0; asset < ASSET_COUNT; asset++)
+    {
+        for (size_t part = 0; part < PART_COUNT; part++)
+        {
+            for (size_t mesh = 0; mesh < MESH_COUNT; mesh++)
+            {
+                geoms.push_back("/scene/asset" + std::to_string(asset) + "/part" + std::to_string(part) + "/mesh" + std::to_string(mesh));
+            }
+        }
+    }
+
+    BENCHMARK("Resolve 10k paths by element")
+    {
+        size_t count = 0;
+        std::vector<mx::MaterialAssignPtr> matAssigns = look->getActiveMaterialAssigns();
+        std::vector<mx::PropertyAssignPtr> propertyAssigns = look->getActivePropertyAssigns();
+        for (size_t i = 0; i < geoms.size(); i += 10)
+        {
+            const std::string& geom = geoms[i];
+            for (mx::MaterialAssignPtr matAssign : matAssigns)
+            {
+                mx::CollectionPtr collection = matAssign->getCollection();
+                if (mx::geomStringsMatch(matAssign->getActiveGeom(), geom, true) ||
+                    (collection && collection->matchesGeomString(geom)))
+                {
+                    count++;
+                }
+            }
+            for (mx::PropertyAssignPtr propertyAssign : propertyAssigns)
+            {
+                if (mx::geomStringsMatch(propertyAssign->getGeom(), geom, true))
+                {
+                    count++;
+                }
+            }
+        }
+        return count;
+    };
+
+    BENCHMARK("Resolve 100k paths by look resolver, single thread")
+    {
+        return mx::LookResolver(look).resolve(geoms, 1).size();
+    };
+
+    BENCHMARK("Resolve 100k paths by look resolver")
+    {
+        return mx::LookResolver(look).resolve(geoms).size();
+    };
+
+    for (size_t i = 0, size = geoms.size(); i < 9; i++)
+    {
+        for (size_t j = 0; j < size; j++)
+        {
+            geoms.push_back(geoms[j] + "/instance" + std::to_string(i));
+        }
+    }
+
+    BENCHMARK("Resolve 1M paths by look resolver")
+    {
+        return mx::LookResolver(look).resolve(geoms).size();
+    };
+}
+#endif
@@ -187,6 +187,116 @@ TEST_CASE("Node", "[node]")
     REQUIRE(doc->getOutputs().empty());
 }
 
+TEST_CASE("Downstream ports", "[node]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    // Create two graphs containing nodes of the same names.
+    mx::NodeGraphPtr graph1 = doc->addNodeGraph("graph1");
+    mx::NodeGraphPtr graph2 = doc->addNodeGraph("graph2");
+    mx::NodePtr source1 = graph1->addNode("constant", "source", "float");
+    mx::NodePtr source2 = graph2->addNode("constant", "source", "float");
+    mx::NodePtr add1 = graph1->addNode("add", "add", "float");
+    mx::NodePtr add2 = graph2->addNode("add", "add", "float");
+    mx::InputPtr in1 = add1->addInput("in1", "float");
+    mx::InputPtr in2 = add1->addInput("in2", "float");
+    in1->setConnectedNode(source1);
+    in2->setConnectedNode(source1);
+    add2->setConnectedNode("in1", source2);
+    mx::OutputPtr out1 = graph1->addOutput("out", "float");
+    out1->setConnectedNode(add1);
+
+    // Verify that downstream ports are scoped to each graph.
+    REQUIRE(source1->getDownstreamPorts() == std::vector<mx::PortElementPtr>{ in2, in1 });
+    REQUIRE(source2->getDownstreamPorts() == std::vector<mx::PortElementPtr>{ add2->getInput("in1") });
+    REQUIRE(add1->getDownstreamPorts() == std::vector<mx::PortElementPtr>{ out1 });
+    REQUIRE(add2->getDownstreamPorts().empty());
+
+    // Verify that downstream ports track connection edits.
+    in2->setConnectedNode(nullptr);
+    REQUIRE(source1->getDownstreamPorts() == std::vector<mx::PortElementPtr>{ in1 });
+    in1->setNodeName("missing");
+    REQUIRE(source1->getDownstreamPorts().empty());
+    source1->setName("missing");
+    REQUIRE(source1->getDownstreamPorts() == std::vector<mx::PortElementPtr>{ in1 });
+    graph1->removeNode(add1->getName());
+    REQUIRE(source1->getDownstreamPorts().empty());
+
+    // Verify nodegraph downstream ports at document scope.
+    mx::NodePtr consumer = doc->addNode("add", "consumer", "float");
+    mx::InputPtr graphInput = consumer->addInput("in1", "float");
+    graphInput->setConnectedOutput(graph2->addOutput("out", "float"));
+    REQUIRE(graph2->getDownstreamPorts() == std::vector<mx::PortElementPtr>{ graphInput });
+    REQUIRE(graph1->getDownstreamPorts().empty());
+
+    // Verify that the bulk map matches individual queries.
+    for (mx::GraphElementPtr graph : { mx::GraphElementPtr(doc), mx::GraphElementPtr(graph1), mx::GraphElementPtr(graph2) })
+    {
+        auto downstreamPortMap = graph->getDownstreamPortMap();
+        for (mx::ElementPtr child : graph->getChildren())
+        {
+            std::vector<mx::PortElementPtr> ports;
+            if (child->isA<mx::Node>())
+            {
+                ports = child->asA<mx::Node>()->getDownstreamPorts();
+            }
+            else if (child->isA<mx::NodeGraph>())
+            {
+                ports = child->asA<mx::NodeGraph>()->getDownstreamPorts();
+            }
+            auto it = downstreamPortMap.find(child);
+            REQUIRE((it != downstreamPortMap.end() ? it->second : std::vector<mx::PortElementPtr>()) == ports);
+        }
+    }
+    REQUIRE(doc->getDownstreamPortMap().size() == 1);
+
+    // Verify that downstream ports match those of a fresh copy after each
+    // edit to a warm index.
+    auto getPortPaths = [](mx::DocumentPtr document)
+    {
+        std::vector<std::string> portPaths;
+        for (mx::ElementPtr elem : document->traverseTree())
+        {
+            std::vector<mx::PortElementPtr> ports;
+            if (elem->isA<mx::Node>())
+            {
+                ports = elem->asA<mx::Node>()->getDownstreamPorts();
+            }
+            else if (elem->isA<mx::NodeGraph>())
+            {
+                ports = elem->asA<mx::NodeGraph>()->getDownstreamPorts();
+            }
+            for (mx::PortElementPtr port : ports)
+            {
+                portPaths.push_back(elem->getNamePath() + " -> " + port->getNamePath());
+            }
+        }
+        return portPaths;
+    };
+    auto verifyPorts = [&]()
+    {
+        REQUIRE(getPortPaths(doc) == getPortPaths(doc->copy()));
+    };
+    add2->setConnectedNode("in2", source2);
+    verifyPorts();
+    add2->getInput("in2")->setName("in0");
+    verifyPorts();
+    graph2->removeNode(source2->getName());
+    verifyPorts();
+    source2 = graph2->addNode("constant", "source", "float");
+    verifyPorts();
+    source2->setName("renamed_source");
+    verifyPorts();
+    graph2->getOutput("out")->setConnectedNode(add2);
+    verifyPorts();
+    graphInput->setOutputString("missing");
+    verifyPorts();
+    graph2->setName("graph3");
+    verifyPorts();
+    doc->removeNodeGraph(graph1->getName());
+    verifyPorts();
+}
+
 TEST_CASE("Node inputCount repro", "[node]")
 {
     // Create a document.
@@ -240,8 +350,107 @@ TEST_CASE("Flatten", "[nodegraph]")
     size_t newRootNodes = doc->getNodes().size();
     size_t expectedRootNodes = (origRootNodes - origCustomNodes) + (origNestedNodes * origCustomNodes);
     REQUIRE(newRootNodes == expectedRootNodes);
+
+    // Flatten library graphs with nested graph implementations.
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+    for (const std::string graphName : { "NG_open_pbr_surface_surfaceshader", "IMPL_gltf_pbr_surfaceshader" })
+    {
+        mx::NodeGraphPtr libraryGraph = libraries->getNodeGraph(graphName);
+        REQUIRE(libraryGraph);
+        mx::DocumentPtr flatDoc = mx::createDocument();
+        flatDoc->setDataLibrary(libraries);
+        mx::NodeGraphPtr graph = flatDoc->addNodeGraph(graphName);
+        graph->copyContentFrom(libraryGraph);
+        graph->flattenSubgraphs();
+        REQUIRE(graph->getNodes().size() > libraryGraph->getNodes().size());
+        for (mx::NodePtr node : graph->getNodes())
+        {
+            mx::InterfaceElementPtr impl = node->getImplementation();
+            REQUIRE((!impl || !impl->isA<mx::NodeGraph>()));
+        }
+        for (mx::OutputPtr output : graph->getOutputs())
+        {
+            REQUIRE(output->getConnectedNode());
+        }
+        REQUIRE(flatDoc->validate());
+    }
+
+    // Flatten a chain of graph-defined nodes, with the downstream node
+    // preceding its upstream node in the graph.
+    mx::DocumentPtr chainDoc = mx::createDocument();
+    chainDoc->setDataLibrary(libraries);
+    mx::NodeGraphPtr chainGraph = chainDoc->addNodeGraph();
+    mx::NodePtr downstream = chainGraph->addNode("randomfloat", "downstream", "float");
+    mx::NodePtr upstream = chainGraph->addNode("randomfloat", "upstream", "float");
+    downstream->setConnectedNode("in", upstream);
+    chainGraph->addOutput("out", "float")->setConnectedNode(downstream);
+    chainGraph->flattenSubgraphs();
+    REQUIRE(!chainGraph->getNode("downstream"));
+    REQUIRE(!chainGraph->getNode("upstream"));
+    REQUIRE(chainDoc->validate());
 }
 
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Flatten performance", "[nodegraph]")
+{
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), libraries);
+
+    // Collect the graph implementations of the bxdf libraries.
+    std::vector<mx::NodeGraphPtr> bxdfGraphs;
+    for (mx::NodeGraphPtr graph : libraries->getNodeGraphs())
+    {
+        if (graph->getActiveSourceUri().find("bxdf") != std::string::npos)
+        {
+            bxdfGraphs.push_back(graph);
+        }
+    }
+    REQUIRE(!bxdfGraphs.empty());
+
+    BENCHMARK("Flatten bxdf library graphs")
+    {
+        size_t nodeCount = 0;
+        for (mx::NodeGraphPtr libraryGraph : bxdfGraphs)
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            doc->setDataLibrary(libraries);
+            mx::NodeGraphPtr graph = doc->addNodeGraph(libraryGraph->getName());
+            graph->copyContentFrom(libraryGraph);
+            graph->flattenSubgraphs();
+            nodeCount += graph->getNodes().size();
+        }
+        return nodeCount;
+    };
+
+    // Collect the bxdf node definitions with graph implementations.
+    std::vector<mx::NodeDefPtr> bxdfNodeDefs;
+    for (mx::NodeDefPtr nodeDef : libraries->getNodeDefs())
+    {
+        mx::InterfaceElementPtr impl = nodeDef->getImplementation();
+        if (impl && impl->isA<mx::NodeGraph>() && nodeDef->getActiveSourceUri().find("bxdf") != std::string::npos)
+        {
+            bxdfNodeDefs.push_back(nodeDef);
+        }
+    }
+
+    BENCHMARK("Flatten bxdf node instances")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        doc->setDataLibrary(libraries);
+        for (int i = 0; i < 5; i++)
+        {
+            for (mx::NodeDefPtr nodeDef : bxdfNodeDefs)
+            {
+                doc->addNodeInstance(nodeDef);
+            }
+        }
+        doc->flattenSubgraphs();
+        return doc->getNodes().size();
+    };
+}
+#endif
+
 TEST_CASE("Inheritance", "[nodedef]")
 {
     mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
@@ -262,6 +471,181 @@ TEST_CASE("Inheritance", "[nodedef]")
         nodedefSpecularInput->getAttribute(mx::ValueElement::VALUE_ATTRIBUTE));
 }
 
+TEST_CASE("Active interface", "[nodedef]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    // Create a base nodedef and a derived nodedef that overrides one input.
+    mx::NodeDefPtr base = doc->addNodeDef("ND_base", "color3", "base");
+    mx::InputPtr baseA = base->addInput("a", "float");
+    mx::InputPtr baseB = base->addInput("b", "float");
+    mx::TokenPtr baseT = base->addToken("t");
+    mx::NodeDefPtr derived = doc->addNodeDef("ND_derived", "color3", "derived");
+    mx::InputPtr derivedB = derived->addInput("b", "float");
+    mx::InputPtr derivedC = derived->addInput("c", "float");
+    mx::TokenPtr derivedT = derived->addToken("t");
+    derived->setInheritsFrom(base);
+
+    // Verify the flattened interface, with derived elements first.
+    REQUIRE(derived->getActiveInputs() == std::vector<mx::InputPtr>{ derivedB, derivedC, baseA });
+    REQUIRE(derived->getActiveOutputs().size() == 1);
+    REQUIRE(derived->getActiveOutput("out") == derived->getOutput("out"));
+    REQUIRE(derived->getActiveTokens() == std::vector<mx::TokenPtr>{ derivedT, baseT });
+    REQUIRE(derived->getActiveToken("t") == derivedT);
+    REQUIRE(derived->getActiveInput("a") == baseA);
+    REQUIRE(derived->getActiveInput("b") == derivedB);
+    REQUIRE(derived->getActiveValueElement("b") == derivedB);
+    REQUIRE(derived->getActiveValueElements().size() == 5);
+    REQUIRE(!derived->getActiveInput("out"));
+    REQUIRE(!derived->getActiveInput("unknown"));
+
+    // Verify that the flattened interface tracks structural edits.
+    mx::InputPtr baseD = base->addInput("d", "float");
+    REQUIRE(derived->getActiveInput("d") == baseD);
+    derivedC->setName("e");
+    REQUIRE(!derived->getActiveInput("c"));
+    REQUIRE(derived->getActiveInput("e") == derivedC);
+    derived->removeInput("b");
+    REQUIRE(derived->getActiveInput("b") == baseB);
+    base->setName("ND_base2");
+    REQUIRE(derived->getActiveInputs().size() == 1);
+    derived->setInheritString("ND_base2");
+    REQUIRE(derived->getActiveInputs().size() == 4);
+    derived->setInheritsFrom(nullptr);
+    REQUIRE(derived->getActiveInputs() == std::vector<mx::InputPtr>{ derivedC });
+    REQUIRE(derived->getActiveTokens() == std::vector<mx::TokenPtr>{ derivedT });
+}
+
+TEST_CASE("Node definition resolution", "[nodedef]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    // Create overloaded nodedefs for a single category.
+    mx::NodeDefPtr floatDef = doc->addNodeDef("ND_blend_float", "float", "blend");
+    floatDef->addInput("in", "float");
+    mx::NodeDefPtr colorDef = doc->addNodeDef("ND_blend_color3", "color3", "blend");
+    colorDef->addInput("in", "color3");
+    mx::NodeDefPtr glslDef = doc->addNodeDef("ND_blend_color3_glsl", "color3", "blend");
+    glslDef->addInput("in", "color3");
+    glslDef->addInput("mix", "float");
+    glslDef->setTarget("genglsl");
+
+    // Verify resolution by output type, input types and target.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr node = nodeGraph->addNode("blend", "blend1", "color3");
+    REQUIRE(node->getNodeDef() == colorDef);
+    REQUIRE(node->getNodeDef("genglsl") == colorDef);
+    mx::InputPtr mix = node->setInputValue("mix", 0.5f);
+    REQUIRE(node->getNodeDef() == glslDef);
+    REQUIRE(node->getNodeDef("genosl", true) == colorDef);
+    REQUIRE(node->getNodeDef("genosl") == nullptr);
+    REQUIRE(node->getNodeDef("genglsl") == glslDef);
+
+    // Verify that resolution tracks edits to the node.
+    node->removeInput(mix->getName());
+    node->setType("float");
+    REQUIRE(node->getNodeDef() == floatDef);
+    node->setInputValue("in", mx::Color3(1.0f));
+    REQUIRE(node->getNodeDef(mx::EMPTY_STRING, true) == floatDef);
+    REQUIRE(node->getNodeDef() == nullptr);
+    node->getInput("in")->setType("float");
+    REQUIRE(node->getNodeDef() == floatDef);
+    node->setCategory("unknown");
+    REQUIRE(node->getNodeDef() == nullptr);
+    node->setCategory("blend");
+    REQUIRE(node->getNodeDef() == floatDef);
+    node->getInput("in")->setName("mix");
+    REQUIRE(node->getNodeDef() == nullptr);
+    node->getInput("mix")->setName("in");
+    REQUIRE(node->getNodeDef() == floatDef);
+
+    // Verify that resolution tracks edits to the nodes that a node inherits
+    // from.
+    mx::NodePtr baseNode = doc->addNode("blend", "base", "float");
+    mx::NodePtr derivedNode = doc->addNode("blend", "derived", "float");
+    derivedNode->setInheritString(baseNode->getName());
+    REQUIRE(derivedNode->getNodeDef() == floatDef);
+    baseNode->setInputValue("in", mx::Color3(1.0f));
+    REQUIRE(derivedNode->getNodeDef() == nullptr);
+    derivedNode->removeAttribute(mx::Element::INHERIT_ATTRIBUTE);
+    REQUIRE(derivedNode->getNodeDef() == floatDef);
+    doc->removeNode(baseNode->getName());
+    doc->removeNode(derivedNode->getName());
+
+    // Verify that resolution tracks edits to nodedefs.
+    mx::NodeDefPtr versionDef = doc->addNodeDef("ND_blend_float_v2", "float", "blend");
+    versionDef->addInput("in", "float");
+    versionDef->setVersionString("2.0");
+    REQUIRE(node->getNodeDef() == floatDef);
+    node->setVersionString("2.0");
+    REQUIRE(node->getNodeDef() == versionDef);
+    node->setVersionString(mx::EMPTY_STRING);
+    floatDef->setVersionString("1.0");
+    REQUIRE(node->getNodeDef() == nullptr);
+    versionDef->setDefaultVersion(true);
+    REQUIRE(node->getNodeDef() == versionDef);
+    versionDef->getOutput("out")->setType("color3");
+    REQUIRE(node->getNodeDef() == nullptr);
+    node->setVersionString("1.0");
+    REQUIRE(node->getNodeDef() == floatDef);
+    doc->removeNodeDef(floatDef->getName());
+    REQUIRE(node->getNodeDef() == nullptr);
+    node->setVersionString(mx::EMPTY_STRING);
+
+    // Verify that resolution tracks edits to data libraries.
+    mx::DocumentPtr library = mx::createDocument();
+    mx::NodeDefPtr libraryDef = library->addNodeDef("ND_blend_float", "float", "blend");
+    doc->setDataLibrary(library);
+    REQUIRE(node->getNodeDef(mx::EMPTY_STRING, true) == libraryDef);
+    REQUIRE(node->getNodeDef() == nullptr);
+    libraryDef->addInput("in", "float");
+    REQUIRE(node->getNodeDef() == libraryDef);
+    libraryDef->getOutput("out")->setType("color3");
+    REQUIRE(node->getNodeDef() == nullptr);
+
+    // Verify that resolution tracks switches between data libraries, whose
+    // revision counters may coincide.
+    mx::DocumentPtr switchDoc = mx::createDocument();
+    mx::NodePtr switchNode = switchDoc->addNode("switchtest", "node1", "float");
+    mx::DocumentPtr library1 = mx::createDocument();
+    mx::NodeDefPtr oldDef = library1->addNodeDef("ND_old", "float", "switchtest");
+    oldDef->setAttribute("node", "switchtest");
+    mx::DocumentPtr library2 = mx::createDocument();
+    mx::NodeDefPtr newDef = library2->addNodeDef("ND_new", "float", "switchtest");
+    switchDoc->setDataLibrary(library1);
+    REQUIRE(switchNode->getNodeDef() == oldDef);
+    switchDoc->setDataLibrary(library2);
+    REQUIRE(switchNode->getNodeDef() == newDef);
+
+    // Verify that resolution matches the standard libraries when frozen.
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr stdlib = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, stdlib);
+    mx::DocumentPtr example = mx::createDocument();
+    mx::readFromXmlFile(example, "resources/Materials/Examples/StandardSurface/standard_surface_brick_procedural.mtlx", searchPath);
+    example->importLibrary(stdlib);
+    std::vector<mx::NodeDefPtr> nodeDefs;
+    for (mx::ElementPtr elem : example->traverseTree())
+    {
+        mx::NodePtr exampleNode = elem->asA<mx::Node>();
+        if (exampleNode)
+        {
+            nodeDefs.push_back(exampleNode->getNodeDef());
+            REQUIRE(nodeDefs.back());
+        }
+    }
+    example->freeze();
+    size_t index = 0;
+    for (mx::ElementPtr elem : example->traverseTree())
+    {
+        mx::NodePtr exampleNode = elem->asA<mx::Node>();
+        if (exampleNode)
+        {
+            REQUIRE(exampleNode->getNodeDef() == nodeDefs[index++]);
+        }
+    }
+}
+
 TEST_CASE("Topological sort", "[nodegraph]")
 {
     // Create a document.
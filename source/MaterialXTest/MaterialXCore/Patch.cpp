@@ -0,0 +1,100 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXTest/External/Catch/catch.hpp>
+
+#include <MaterialXCore/Patch.h>
+#include <MaterialXFormat/Util.h>
+#include <MaterialXFormat/XmlIo.h>
+
+#include <algorithm>
+
+namespace mx = MaterialX;
+
+TEST_CASE("Document patches", "[patch]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, "resources/Materials/Examples/StandardSurface/standard_surface_brick_procedural.mtlx", searchPath);
+
+    // Identical documents produce an empty patch.
+    mx::DocumentPtr edited = doc->copy();
+    REQUIRE(mx::createPatch(doc, edited).empty());
+
+    // Edit a copy of the document.
+    mx::NodeGraphPtr nodeGraph = edited->getNodeGraphs()[0];
+    mx::InputPtr input = nodeGraph->getInput("hue_variation");
+    input->setValueString("0.5");
+    input->removeAttribute(mx::ValueElement::UI_NAME_ATTRIBUTE);
+    nodeGraph->getNodes()[0]->setAttribute(mx::Element::XPOS_ATTRIBUTE, "2.5");
+    mx::NodePtr constant = nodeGraph->addNode("constant", "added_constant", "float");
+    constant->setInputValue("value", 0.25f);
+    nodeGraph->setChildIndex(constant->getName(), 0);
+    nodeGraph->removeNode(nodeGraph->getNodes().back()->getName());
+    edited->getMaterialNodes()[0]->setCategory("surfacematerial_custom");
+    edited->setChildIndex(edited->getChildren().back()->getName(), 0);
+
+    // Verify that the patch transforms the original into the edited document.
+    mx::PatchOperationVec patch = mx::createPatch(doc, edited);
+    REQUIRE(!patch.empty());
+    mx::DocumentPtr patched = doc->copy();
+    mx::applyPatch(patched, patch);
+    REQUIRE(*patched == *edited);
+    REQUIRE(mx::createPatch(patched, edited).empty());
+
+    // Verify that unedited values are not included in the patch.
+    mx::PatchOperation valueOp(mx::PatchOperation::TypeSetAttribute, input->getNamePath(),
+                               mx::ValueElement::VALUE_ATTRIBUTE, "0.5");
+    REQUIRE(std::count(patch.begin(), patch.end(), valueOp) == 1);
+    for (const mx::PatchOperation& op : patch)
+    {
+        REQUIRE(op.getNamePath().find("value_variation") == std::string::npos);
+    }
+
+    // Verify that patches may be reversed, and applied to subtrees.
+    mx::applyPatch(patched, mx::createPatch(edited, doc));
+    REQUIRE(*patched == *doc);
+    mx::NodeGraphPtr patchedGraph = patched->getNodeGraph(nodeGraph->getName());
+    mx::applyPatch(patchedGraph, mx::createPatch(doc->getNodeGraph(nodeGraph->getName()), nodeGraph));
+    REQUIRE(*patchedGraph == *nodeGraph);
+
+    // Verify that a patch may build a document from scratch.
+    mx::DocumentPtr empty = mx::createDocument();
+    mx::applyPatch(empty, mx::createPatch(mx::createDocument(), doc));
+    REQUIRE(*empty == *doc);
+
+    // Operations addressing missing elements are rejected.
+    mx::DocumentPtr other = mx::createDocument();
+    REQUIRE_THROWS_AS(mx::applyPatch(other, patch), mx::Exception);
+    mx::PatchOperationVec duplicate = { mx::PatchOperation(mx::PatchOperation::TypeAddElement, nodeGraph->getName(), mx::NodeGraph::CATEGORY) };
+    REQUIRE_THROWS_AS(mx::applyPatch(doc->copy(), duplicate), mx::Exception);
+}
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Document patch performance", "[patch]")
+{
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), libraries);
+    mx::DocumentPtr source = libraries->copy();
+    mx::DocumentPtr replica = libraries->copy();
+    mx::InputPtr input = source->getNodeDef("ND_image_color3")->getInput("default");
+    int counter = 0;
+
+    BENCHMARK("Synchronize edit by XML serialization")
+    {
+        input->setValue(mx::Color3((float) counter++));
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlString(doc, mx::writeToXmlString(source));
+        return doc;
+    };
+
+    BENCHMARK("Synchronize edit by patch")
+    {
+        input->setValue(mx::Color3((float) counter++));
+        mx::applyPatch(replica, mx::createPatch(replica, source));
+        return replica;
+    };
+}
+#endif
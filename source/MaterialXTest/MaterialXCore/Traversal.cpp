@@ -15,12 +15,16 @@ TEST_CASE("IntraGraph Traversal", "[traversal]")
 {
     // Test null iterators.
     mx::TreeIterator nullTree = mx::NULL_TREE_ITERATOR;
+    mx::RawTreeIterator nullRawTree = mx::NULL_RAW_TREE_ITERATOR;
     mx::GraphIterator nullGraph = mx::NULL_GRAPH_ITERATOR;
     REQUIRE(*nullTree == nullptr);
+    REQUIRE(*nullRawTree == nullptr);
     REQUIRE(*nullGraph == mx::NULL_EDGE);
     ++nullTree;
+    ++nullRawTree;
     ++nullGraph;
     REQUIRE((nullTree == mx::NULL_TREE_ITERATOR));
+    REQUIRE((nullRawTree == mx::NULL_RAW_TREE_ITERATOR));
     REQUIRE((nullGraph == mx::NULL_GRAPH_ITERATOR));
 
     // Create a document.
@@ -99,6 +103,30 @@ TEST_CASE("IntraGraph Traversal", "[traversal]")
     }
     REQUIRE(nodeCount == 0);
 
+    // Traverse the document tree (raw iterator).
+    std::vector<std::pair<mx::Element*, size_t>> treeElements, rawElements;
+    for (mx::TreeIterator it = doc->traverseTree().begin(); it != mx::TreeIterator::end(); ++it)
+    {
+        treeElements.emplace_back(it.getElement().get(), it.getElementDepth());
+    }
+    for (mx::RawTreeIterator it = doc->traverseTreeRaw().begin(); it != mx::RawTreeIterator::end(); ++it)
+    {
+        rawElements.emplace_back(it.getElement(), it.getElementDepth());
+    }
+    REQUIRE(rawElements == treeElements);
+
+    // Traverse the document tree (raw iterator, prune subtree).
+    size_t elementCount = 0;
+    for (mx::RawTreeIterator it = doc->traverseTreeRaw().begin(); it != mx::RawTreeIterator::end(); ++it)
+    {
+        elementCount++;
+        if (it.getElement() == nodeGraph.get())
+        {
+            it.setPruneSubtree(true);
+        }
+    }
+    REQUIRE(elementCount == 2);
+
     // Traverse upstream from the graph output (implicit iterator).
     nodeCount = 0;
     for (mx::Edge edge : output->traverseGraph())
@@ -191,3 +219,31 @@ TEST_CASE("InterGraph Traversal", "[traversal]")
         }
     }
 }
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Traversal performance", "[traversal]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), doc);
+
+    BENCHMARK("Traverse document tree")
+    {
+        size_t depth = 0;
+        for (mx::TreeIterator it = doc->traverseTree().begin(); it != mx::TreeIterator::end(); ++it)
+        {
+            depth += it.getElementDepth();
+        }
+        return depth;
+    };
+
+    BENCHMARK("Traverse document tree (raw)")
+    {
+        size_t depth = 0;
+        for (mx::RawTreeIterator it = doc->traverseTreeRaw().begin(); it != mx::RawTreeIterator::end(); ++it)
+        {
+            depth += it.getElementDepth();
+        }
+        return depth;
+    };
+}
+#endif
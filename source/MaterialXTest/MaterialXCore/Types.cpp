@@ -120,4 +120,127 @@ TEST_CASE("Matrices", "[types]")
     REQUIRE((rotX * rotY).isEquivalent(mx::Matrix44::createScale({-1, -1, 1}), EPSILON));
     REQUIRE((rotX * rotZ).isEquivalent(mx::Matrix44::createScale({-1, 1, -1}), EPSILON));
     REQUIRE((rotY * rotZ).isEquivalent(mx::Matrix44::createScale({1, -1, -1}), EPSILON));
+
+    // Vector transformations
+    mx::Matrix44 xform = scale * trans;
+    REQUIRE(xform.multiply(mx::Vector4(1, 1, 1, 1)) == mx::Vector4(3, 4, 5, 1));
+    REQUIRE(xform.transformPoint(mx::Vector3(1, 1, 1)) == mx::Vector3(3, 4, 5));
+    REQUIRE(xform.transformVector(mx::Vector3(1, 1, 1)) == mx::Vector3(2, 2, 2));
+    REQUIRE(xform.transformNormal(mx::Vector3(1, 1, 1)) == mx::Vector3(0.5f, 0.5f, 0.5f));
+
+    // Matrix products match the row-by-row products of vectors and matrices
+    mx::Matrix44 rotXYZ = rotX * mx::Matrix44::createRotationY(PI / 3) * mx::Matrix44::createRotationZ(PI / 5) * xform;
+    mx::Matrix44 rotProd = rotXYZ * rotXYZ;
+    for (size_t i = 0; i < 4; i++)
+    {
+        mx::Vector4 row(rotXYZ[i][0], rotXYZ[i][1], rotXYZ[i][2], rotXYZ[i][3]);
+        REQUIRE(mx::Vector4(rotProd[i].data(), rotProd[i].data() + 4) == rotXYZ.multiply(row));
+    }
+
+    // Matrix products and transformations match explicit scalar sums, to
+    // within the rounding differences of fused multiply-add contraction
+    const mx::Matrix44& m = rotXYZ;
+    for (size_t i = 0; i < 4; i++)
+    {
+        for (size_t j = 0; j < 4; j++)
+        {
+            float sum = m[i][0] * m[0][j] + m[i][1] * m[1][j] + m[i][2] * m[2][j] + m[i][3] * m[3][j];
+            REQUIRE(std::abs(rotProd[i][j] - sum) < EPSILON);
+        }
+    }
+    mx::Vector3 v(0.3f, -1.7f, 2.9f);
+    mx::Vector3 point = m.transformPoint(v);
+    mx::Vector3 vector = m.transformVector(v);
+    for (size_t j = 0; j < 3; j++)
+    {
+        float vectorSum = v[0] * m[0][j] + v[1] * m[1][j] + v[2] * m[2][j];
+        REQUIRE(std::abs(vector[j] - vectorSum) < EPSILON);
+        REQUIRE(std::abs(point[j] - (vectorSum + m[3][j])) < EPSILON);
+    }
+
+    // Array transformations match single transformations exactly
+    std::vector<mx::Vector3> vectors;
+    for (int i = 0; i < 37; i++)
+    {
+        vectors.emplace_back(std::sin(i * 0.1f), std::cos(i * 0.7f) * 10.0f, i * 0.37f - 5.0f);
+    }
+    std::vector<mx::Vector3> points(vectors.size()), normals(vectors.size());
+    rotXYZ.transformPoints(vectors.data(), points.data(), vectors.size());
+    rotXYZ.transformNormals(vectors.data(), normals.data(), vectors.size());
+    for (size_t i = 0; i < vectors.size(); i++)
+    {
+        REQUIRE(points[i] == rotXYZ.transformPoint(vectors[i]));
+        REQUIRE(normals[i] == rotXYZ.transformNormal(vectors[i]));
+    }
+    std::vector<mx::Vector3> inPlace = vectors;
+    rotXYZ.transformVectors(inPlace.data(), inPlace.data(), inPlace.size());
+    for (size_t i = 0; i < vectors.size(); i++)
+    {
+        REQUIRE(inPlace[i] == rotXYZ.transformVector(vectors[i]));
+    }
+}
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Matrix performance", "[types]")
+{
+    mx::Matrix44 xform = mx::Matrix44::createRotationX(PI / 3) *
+                         mx::Matrix44::createScale({ 1, 2, 3 }) *
+                         mx::Matrix44::createTranslation({ 4, 5, 6 });
+    std::vector<mx::Vector3> vectors;
+    for (int i = 0; i < 100000; i++)
+    {
+        vectors.emplace_back(std::sin(i * 0.1f), std::cos(i * 0.7f), i * 0.01f);
+    }
+    std::vector<mx::Vector3> result(vectors.size());
+
+    BENCHMARK("Multiply matrices")
+    {
+        mx::Matrix44 prod = xform;
+        for (int i = 0; i < 10000; i++)
+        {
+            prod = prod * xform;
+        }
+        return prod;
+    };
+
+    BENCHMARK("Invert matrices")
+    {
+        mx::Matrix44 inv = xform;
+        for (int i = 0; i < 10000; i++)
+        {
+            inv = inv.getInverse();
+        }
+        return inv;
+    };
+
+    BENCHMARK("Transform points")
+    {
+        for (size_t i = 0; i < vectors.size(); i++)
+        {
+            result[i] = xform.transformPoint(vectors[i]);
+        }
+        return result.back();
+    };
+
+    BENCHMARK("Transform point array")
+    {
+        xform.transformPoints(vectors.data(), result.data(), vectors.size());
+        return result.back();
+    };
+
+    BENCHMARK("Transform normals")
+    {
+        for (size_t i = 0; i < 10000; i++)
+        {
+            result[i] = xform.transformNormal(vectors[i]);
+        }
+        return result[9999];
+    };
+
+    BENCHMARK("Transform normal array")
+    {
+        xform.transformNormals(vectors.data(), result.data(), 10000);
+        return result[9999];
+    };
 }
+#endif
@@ -5,8 +5,12 @@
 
 #include <MaterialXTest/External/Catch/catch.hpp>
 
+#include <MaterialXCore/Document.h>
 #include <MaterialXCore/Util.h>
 #include <MaterialXCore/Value.h>
+#include <MaterialXFormat/Util.h>
+
+#include <sstream>
 
 namespace mx = MaterialX;
 
@@ -89,6 +93,84 @@ TEST_CASE("Value strings", "[value]")
     REQUIRE(mx::parseStructValueString("{1;2;{3};4}") == (std::vector<std::string>{"1","2","{3}","4"}));
 }
 
+TEST_CASE("Value string conversions", "[value]")
+{
+    // Reference conversions through classic-locale streams.
+    auto formatReference = [](float value)
+    {
+        std::ostringstream ss;
+        ss.imbue(std::locale::classic());
+        mx::Value::FloatFormat fmt = mx::Value::getFloatFormat();
+        ss.setf(std::ios_base::fmtflags(
+                (fmt == mx::Value::FloatFormatFixed ? std::ios_base::fixed :
+                (fmt == mx::Value::FloatFormatScientific ? std::ios_base::scientific : 0))),
+            std::ios_base::floatfield);
+        ss.precision(mx::Value::getFloatPrecision());
+        ss << value;
+        return ss.str();
+    };
+    auto parseReference = [](const std::string& str, float& value)
+    {
+        std::istringstream ss(str);
+        ss.imbue(std::locale::classic());
+        return bool(ss >> value);
+    };
+
+    // Verify that formatting matches stream output for each float format.
+    std::vector<float> values = { 0.0f, -0.0f, 1.0f, -1.5f, 0.1f, 1.0f / 3.0f, 123456.789f, 1.0e-8f,
+                                  3.0e38f, 1.17549435e-38f, 16777217.0f, 0.5f, 2.5f };
+    for (mx::Value::FloatFormat format : { mx::Value::FloatFormatDefault, mx::Value::FloatFormatFixed, mx::Value::FloatFormatScientific })
+    {
+        for (int precision : { 0, 1, 3, 6, 9, 17 })
+        {
+            mx::ScopedFloatFormatting fmt(format, precision);
+            for (float value : values)
+            {
+                REQUIRE(mx::toValueString(value) == formatReference(value));
+            }
+            mx::Color3 color(values[4], values[5], values[6]);
+            REQUIRE(mx::toValueString(color) == formatReference(color[0]) + ", " + formatReference(color[1]) + ", " + formatReference(color[2]));
+        }
+    }
+
+    // Verify exact round trips at full precision.
+    {
+        mx::ScopedFloatFormatting fmt(mx::Value::FloatFormatDefault, 9);
+        for (float value : values)
+        {
+            REQUIRE(mx::fromValueString<float>(mx::toValueString(value)) == value);
+        }
+        mx::Matrix44 matrix(1.0f / 3.0f, 2.0f, 3.0f, 4.0f,
+                            5.0f, 6.0f / 7.0f, 7.0f, 8.0f,
+                            9.0f, 10.0f, 11.0f / 13.0f, 12.0f,
+                            13.0f, 14.0f, 15.0f, 16.0f / 17.0f);
+        REQUIRE(mx::fromValueString<mx::Matrix44>(mx::toValueString(matrix)) == matrix);
+        mx::FloatVec floats = { 0.1f, 0.2f, 0.3f };
+        REQUIRE(mx::fromValueString<mx::FloatVec>(mx::toValueString(floats)) == floats);
+    }
+
+    // Verify that parsing accepts and rejects the same tokens as streams.
+    for (const std::string token : { "1", "-1", "+1", " 1", ".5", "-.5", "5.", "1e3", "1E-3", "1.5abc",
+                                      "0x10", "1e400", "-1e400", "1e-50", "inf", "nan", "-", ".", "", "abc" })
+    {
+        float expected = 0.0f;
+        if (parseReference(token, expected))
+        {
+            REQUIRE(mx::fromValueString<float>(token) == expected);
+        }
+        else
+        {
+            REQUIRE_THROWS_AS(mx::fromValueString<float>(token), mx::ExceptionTypeError);
+        }
+    }
+    REQUIRE(mx::fromValueString<int>("12.5") == 12);
+    REQUIRE_THROWS_AS(mx::fromValueString<int>("99999999999"), mx::ExceptionTypeError);
+    REQUIRE(mx::fromValueString<mx::Vector3>("1,2 3") == mx::Vector3(1.0f, 2.0f, 3.0f));
+    REQUIRE(mx::fromValueString<mx::IntVec>("1, 2,,3") == (mx::IntVec{ 1, 2, 3 }));
+    REQUIRE_THROWS_AS(mx::fromValueString<mx::Vector3>("1, 2, x"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<mx::Vector3>("1, 2, 3, 4"), mx::ExceptionTypeError);
+}
+
 TEST_CASE("Typed values", "[value]")
 {
     // Base types
@@ -131,3 +213,127 @@ TEST_CASE("Typed values", "[value]")
     REQUIRE(value->isA<std::string>());
     REQUIRE(value->asA<std::string>() == "text");
 }
+
+TEST_CASE("Value elements", "[value]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodePtr node = doc->addNode("constant", "node1", "color3");
+    mx::InputPtr input = node->setInputValue("value", mx::Color3(0.1f, 0.2f, 0.3f));
+
+    // Parsed values are shared until the value string changes.
+    mx::ValuePtr value = input->getValue();
+    REQUIRE(value->asA<mx::Color3>() == mx::Color3(0.1f, 0.2f, 0.3f));
+    REQUIRE(input->getValue() == value);
+    input->setValueString("0.4, 0.5, 0.6");
+    REQUIRE(input->getValue() != value);
+    REQUIRE(input->getValue()->asA<mx::Color3>() == mx::Color3(0.4f, 0.5f, 0.6f));
+
+    // Parsed values follow changes to the type.
+    input->setType("vector3");
+    REQUIRE(input->getValue()->asA<mx::Vector3>() == mx::Vector3(0.4f, 0.5f, 0.6f));
+    input->setValue(2.0f);
+    REQUIRE(input->getValue()->asA<float>() == 2.0f);
+
+    // Parsed values are cleared along with the value string.
+    input->removeAttribute(mx::ValueElement::VALUE_ATTRIBUTE);
+    REQUIRE(!input->getValue());
+    input->setValueString("3.0");
+    REQUIRE(input->getValue()->asA<float>() == 3.0f);
+
+    // Parsed values follow copies of element content.
+    mx::InputPtr input2 = node->addInput("value2", "integer");
+    input2->setValue(5);
+    REQUIRE(input2->getValue()->asA<int>() == 5);
+    input2->copyContentFrom(input);
+    REQUIRE(input2->getValue()->asA<float>() == 3.0f);
+
+    // Access typed values directly, with and without a parsed value.
+    mx::InputPtr input3 = node->setInputValue("value3", mx::Vector2(1.0f, 2.0f));
+    REQUIRE(input3->getValueAs<mx::Vector2>() == mx::Vector2(1.0f, 2.0f));
+    REQUIRE(input3->getValue());
+    REQUIRE(input3->getValueAs<mx::Vector2>() == mx::Vector2(1.0f, 2.0f));
+    REQUIRE(input3->getValueAs<mx::Vector3>() == mx::Vector3(0.0f));
+    REQUIRE(input3->getValueAs<float>() == 0.0f);
+    input3->setValueString("1, x");
+    REQUIRE(input3->getValueAs<mx::Vector2>() == mx::Vector2(0.0f));
+    input3->removeAttribute(mx::ValueElement::VALUE_ATTRIBUTE);
+    REQUIRE(input3->getValueAs<mx::Vector2>() == mx::Vector2(0.0f));
+
+    // String values of custom types resolve through generic values.
+    mx::InputPtr input4 = node->addInput("file", "filename");
+    input4->setValueString("image.png");
+    REQUIRE(input4->getValueAs<std::string>() == "image.png");
+}
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Value string conversion performance", "[value]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, doc);
+
+    // Gather the value elements of the standard libraries.
+    std::vector<mx::ValueElementPtr> valueElements;
+    for (mx::ElementPtr elem : doc->traverseTree())
+    {
+        mx::ValueElementPtr valueElem = elem->asA<mx::ValueElement>();
+        if (valueElem && valueElem->hasValueString())
+        {
+            valueElements.push_back(valueElem);
+        }
+    }
+
+    BENCHMARK("Parse library values")
+    {
+        size_t count = 0;
+        for (mx::ValueElementPtr valueElem : valueElements)
+        {
+            count += mx::Value::createValueFromStrings(valueElem->getValueString(), valueElem->getType()) != nullptr;
+        }
+        return count;
+    };
+    BENCHMARK("Get library typed values")
+    {
+        float sum = 0.0f;
+        for (mx::ValueElementPtr valueElem : valueElements)
+        {
+            sum += valueElem->getValueAs<float>();
+            sum += valueElem->getValueAs<mx::Color3>()[0];
+        }
+        return sum;
+    };
+    BENCHMARK("Get library values")
+    {
+        size_t count = 0;
+        for (mx::ValueElementPtr valueElem : valueElements)
+        {
+            count += valueElem->getValue() != nullptr;
+        }
+        return count;
+    };
+
+    mx::Matrix44 matrix(1.0f / 3.0f, 2.0f, 3.0f, 4.0f,
+                        5.0f, 6.0f / 7.0f, 7.0f, 8.0f,
+                        9.0f, 10.0f, 11.0f / 13.0f, 12.0f,
+                        13.0f, 14.0f, 15.0f, 16.0f / 17.0f);
+    std::string matrixString = mx::toValueString(matrix);
+    BENCHMARK("Parse matrix44 strings")
+    {
+        mx::Matrix44 result;
+        for (size_t i = 0; i < 1000; i++)
+        {
+            result = mx::fromValueString<mx::Matrix44>(matrixString);
+        }
+        return result;
+    };
+    BENCHMARK("Format matrix44 strings")
+    {
+        size_t length = 0;
+        for (size_t i = 0; i < 1000; i++)
+        {
+            length += mx::toValueString(matrix).size();
+        }
+        return length;
+    };
+}
+#endif
@@ -0,0 +1,158 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXTest/External/Catch/catch.hpp>
+
+#include <MaterialXFormat/BinaryIo.h>
+#include <MaterialXFormat/Util.h>
+#include <MaterialXFormat/XmlIo.h>
+
+#include <filesystem>
+
+namespace mx = MaterialX;
+
+namespace
+{
+
+// A binary file in the temporary directory, removed when the test completes.
+class TempBinaryFile
+{
+  public:
+    explicit TempBinaryFile(const std::string& name) :
+        _path((std::filesystem::temp_directory_path() / (name + "." + mx::MTLX_BINARY_EXTENSION)).string())
+    {
+    }
+    ~TempBinaryFile()
+    {
+        std::error_code ec;
+        std::filesystem::remove(_path.asString(), ec);
+    }
+
+    const mx::FilePath& getPath() const
+    {
+        return _path;
+    }
+
+  private:
+    mx::FilePath _path;
+};
+
+} // anonymous namespace
+
+TEST_CASE("Binary round trip", "[binaryio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    // Verify that the standard libraries round trip through the binary format.
+    std::string binary = mx::writeToBinaryString(libraries);
+    mx::DocumentPtr binaryLibraries = mx::createDocument();
+    mx::readFromBinaryString(binaryLibraries, binary);
+    REQUIRE(*binaryLibraries == *libraries);
+    REQUIRE(mx::writeToXmlString(binaryLibraries) == mx::writeToXmlString(libraries));
+    for (mx::ElementPtr elem : libraries->getChildren())
+    {
+        REQUIRE(binaryLibraries->getChild(elem->getName())->getSourceUri() == elem->getSourceUri());
+    }
+
+    // Verify that binary files are read with the same content.
+    TempBinaryFile binaryFile("MaterialXTest_libraries");
+    const mx::FilePath& binaryPath = binaryFile.getPath();
+    mx::writeToBinaryFile(libraries, binaryPath);
+    mx::DocumentPtr fileLibraries = mx::createDocument();
+    mx::readFromBinaryFile(fileLibraries, binaryPath);
+    REQUIRE(*fileLibraries == *libraries);
+    REQUIRE(mx::writeToXmlString(fileLibraries) == mx::writeToXmlString(libraries));
+    REQUIRE(binaryPath.exists());
+
+    // Verify that example documents, including comments, newlines and
+    // XIncludes, produce identical XML after a binary round trip.
+    mx::FilePath examplesPath = searchPath.find("resources/Materials/Examples/StandardSurface");
+    for (const mx::FilePath& filename : examplesPath.getFilesInDirectory(mx::MTLX_EXTENSION))
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::XmlReadOptions readOptions;
+        readOptions.readComments = true;
+        readOptions.readNewlines = true;
+        readOptions.upgradeVersion = false;
+        mx::readFromXmlFile(doc, examplesPath / filename, searchPath, &readOptions);
+
+        mx::DocumentPtr binaryDoc = mx::createDocument();
+        mx::BinaryReadOptions binaryReadOptions;
+        binaryReadOptions.upgradeVersion = false;
+        mx::readFromBinaryString(binaryDoc, mx::writeToBinaryString(doc), &binaryReadOptions);
+        REQUIRE(*binaryDoc == *doc);
+        REQUIRE(binaryDoc->getSourceUri() == doc->getSourceUri());
+        REQUIRE(mx::writeToXmlString(binaryDoc) == mx::writeToXmlString(doc));
+    }
+
+    // Verify that element predicates are applied.
+    mx::BinaryWriteOptions writeOptions;
+    writeOptions.elementPredicate = [](mx::ConstElementPtr elem)
+    {
+        return !elem->isA<mx::NodeDef>();
+    };
+    mx::DocumentPtr filteredDoc = mx::createDocument();
+    mx::readFromBinaryString(filteredDoc, mx::writeToBinaryString(libraries, &writeOptions));
+    REQUIRE(filteredDoc->getNodeDefs().empty());
+    REQUIRE(filteredDoc->getImplementations().size() == libraries->getImplementations().size());
+
+    // Verify that existing elements are retained when reading into a document.
+    mx::DocumentPtr mergedDoc = mx::createDocument();
+    mx::NodeDefPtr nodeDef = mergedDoc->addNodeDef("ND_image_color3", "color3", "custom");
+    mx::readFromBinaryString(mergedDoc, binary);
+    REQUIRE(mergedDoc->getNodeDef("ND_image_color3") == nodeDef);
+    REQUIRE(nodeDef->getNodeString() == "custom");
+    REQUIRE(mergedDoc->getNodeDefs().size() == libraries->getNodeDefs().size());
+}
+
+TEST_CASE("Binary read errors", "[binaryio]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->addNode("constant", "node1", "color3");
+    std::string binary = mx::writeToBinaryString(doc);
+
+    // Truncated and malformed buffers are rejected.
+    for (size_t size : { (size_t) 0, (size_t) 16, binary.size() - 1 })
+    {
+        mx::DocumentPtr truncatedDoc = mx::createDocument();
+        REQUIRE_THROWS_AS(mx::readFromBinaryBuffer(truncatedDoc, binary.data(), size), mx::ExceptionParseError);
+    }
+    std::string xml = mx::writeToXmlString(doc);
+    REQUIRE_THROWS_AS(mx::readFromBinaryString(mx::createDocument(), xml), mx::ExceptionParseError);
+    std::string corrupted = binary;
+    corrupted[8] = 2;
+    REQUIRE_THROWS_AS(mx::readFromBinaryString(mx::createDocument(), corrupted), mx::ExceptionParseError);
+
+    // Missing files are reported.
+    REQUIRE_THROWS_AS(mx::readFromBinaryFile(mx::createDocument(), "missing." + mx::MTLX_BINARY_EXTENSION), mx::ExceptionFileMissing);
+}
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Binary load performance", "[binaryio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+    TempBinaryFile binaryFile("MaterialXTest_libraries_benchmark");
+    const mx::FilePath& binaryPath = binaryFile.getPath();
+    mx::writeToBinaryFile(libraries, binaryPath);
+
+    BENCHMARK("Load libraries from XML")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::loadLibraries({ "libraries" }, searchPath, doc);
+        return doc;
+    };
+
+    BENCHMARK("Load libraries from binary")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromBinaryFile(doc, binaryPath);
+        return doc;
+    };
+}
+#endif
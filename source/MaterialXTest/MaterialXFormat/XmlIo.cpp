@@ -349,3 +349,59 @@ TEST_CASE("Locale region testing", "[xmlio]")
     // Restore the original locale.
     std::locale::global(origLocale);
 }
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Load content performance", "[xmlio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    mx::FilePathVec filenames;
+    mx::FilePath examplesPath = searchPath.find("resources/Materials/Examples");
+    for (const mx::FilePath& dir : examplesPath.getSubDirectories())
+    {
+        for (const mx::FilePath& filename : dir.getFilesInDirectory(mx::MTLX_EXTENSION))
+        {
+            filenames.push_back(dir / filename);
+        }
+    }
+
+    std::vector<mx::DocumentPtr> docs;
+    BENCHMARK("Load examples and import libraries")
+    {
+        docs.clear();
+        for (const mx::FilePath& filename : filenames)
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            mx::readFromXmlFile(doc, filename, searchPath);
+            doc->importLibrary(libraries);
+            docs.push_back(doc);
+        }
+        return docs.size();
+    };
+
+    BENCHMARK("Traverse examples")
+    {
+        size_t typedCount = 0;
+        for (mx::DocumentPtr doc : docs)
+        {
+            for (mx::ElementPtr elem : doc->traverseTree())
+            {
+                typedCount += elem->hasAttribute(mx::TypedElement::TYPE_ATTRIBUTE);
+            }
+        }
+        return typedCount;
+    };
+
+    BENCHMARK("Validate examples")
+    {
+        size_t validCount = 0;
+        for (mx::DocumentPtr doc : docs)
+        {
+            validCount += doc->validate();
+        }
+        return validCount;
+    };
+}
+#endif
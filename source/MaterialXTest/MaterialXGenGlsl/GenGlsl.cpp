@@ -124,6 +124,47 @@ TEST_CASE("GenShader: GLSL Performance Test", "[genglsl]")
         return GenShaderUtil::shaderGenPerformanceTest(context);
     };
 }
+
+TEST_CASE("GenShader: GLSL Examples Performance Test", "[genglsl]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr library = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, library);
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    mx::ColorManagementSystemPtr colorManagementSystem = mx::DefaultColorManagementSystem::create(context.getShaderGenerator().getTarget());
+    colorManagementSystem->loadLibrary(library);
+    context.getShaderGenerator().setColorManagementSystem(colorManagementSystem);
+
+    // Load all example documents, and gather their renderable elements.
+    std::vector<mx::DocumentPtr> docs;
+    mx::StringVec docPaths;
+    mx::loadDocuments(searchPath.find("resources/Materials/Examples"), searchPath, {}, {}, docs, docPaths);
+    std::vector<mx::TypedElementPtr> elements;
+    for (mx::DocumentPtr doc : docs)
+    {
+        doc->importLibrary(library);
+        for (mx::TypedElementPtr elem : mx::findRenderableElements(doc))
+        {
+            elements.push_back(elem);
+        }
+    }
+    REQUIRE(!elements.empty());
+
+    // Measure the cost of generating shaders for all renderable elements,
+    // with the document contents already loaded.
+    BENCHMARK("Generate shaders for all examples")
+    {
+        size_t shaderCount = 0;
+        for (mx::TypedElementPtr elem : elements)
+        {
+            mx::ShaderPtr shader = context.getShaderGenerator().generate(elem->getName(), elem, context);
+            shaderCount += shader ? 1 : 0;
+        }
+        return shaderCount;
+    };
+}
 #endif
 
 enum class GlslType
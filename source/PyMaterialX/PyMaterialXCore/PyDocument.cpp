@@ -31,6 +31,9 @@ void bindPyDocument(py::module& mod)
         .def("copy", &mx::Document::copy)
         .def("importLibrary", &mx::Document::importLibrary)
         .def("getReferencedSourceUris", &mx::Document::getReferencedSourceUris)
+        .def("setDataLibrary", &mx::Document::setDataLibrary)
+        .def("getDataLibrary", &mx::Document::getDataLibrary)
+        .def("hasDataLibrary", &mx::Document::hasDataLibrary)
         .def("addNodeGraph", &mx::Document::addNodeGraph,
             py::arg("name") = mx::EMPTY_STRING)
         .def("getNodeGraph", &mx::Document::getNodeGraph)
@@ -116,5 +119,9 @@ void bindPyDocument(py::module& mod)
         .def("getColorManagementSystem", &mx::Document::getColorManagementSystem)
         .def("setColorManagementConfig", &mx::Document::setColorManagementConfig)
         .def("hasColorManagementConfig", &mx::Document::hasColorManagementConfig)
-        .def("getColorManagementConfig", &mx::Document::getColorManagementConfig);
+        .def("getColorManagementConfig", &mx::Document::getColorManagementConfig)
+        .def("setNamePathIndexing", &mx::Document::setNamePathIndexing)
+        .def("getNamePathIndexing", &mx::Document::getNamePathIndexing)
+        .def("freeze", &mx::Document::freeze)
+        .def("isFrozen", &mx::Document::isFrozen);
 }
@@ -73,6 +73,9 @@ void bindPyElement(py::module& mod)
         .def("hasAttribute", &mx::Element::hasAttribute)
         .def("getAttribute", &mx::Element::getAttribute)
         .def("getAttributeNames", &mx::Element::getAttributeNames)
+        .def("getAttributeCount", &mx::Element::getAttributeCount)
+        .def("getAttributeName", &mx::Element::getAttributeName)
+        .def("getAttributeValue", &mx::Element::getAttributeValue)
         .def("removeAttribute", &mx::Element::removeAttribute)
         .def("getSelf", static_cast<mx::ElementPtr (mx::Element::*)()>(&mx::Element::getSelf))
         .def("getParent", static_cast<mx::ElementPtr(mx::Element::*)()>(&mx::Element::getParent))
@@ -103,6 +106,10 @@ void bindPyElement(py::module& mod)
              py::arg("geom") = mx::EMPTY_STRING)
         .def("asString", &mx::Element::asString)
         .def("__str__", &mx::Element::asString)
+        .def("getContentHash", &mx::Element::getContentHash,
+             py::arg("excludeUiAttributes") = false)
+        .def("getUpstreamHash", &mx::Element::getUpstreamHash,
+             py::arg("excludeUiAttributes") = false)
         BIND_ELEMENT_FUNC_INSTANCE(Collection)
         BIND_ELEMENT_FUNC_INSTANCE(Document)
         BIND_ELEMENT_FUNC_INSTANCE(GeomInfo)
@@ -212,6 +219,7 @@ void bindPyElement(py::module& mod)
     py::class_<mx::ElementPredicate>(mod, "ElementPredicate");
 
     py::register_exception<mx::ExceptionOrphanedElement>(mod, "ExceptionOrphanedElement");
+    py::register_exception<mx::ExceptionFrozenDocument>(mod, "ExceptionFrozenDocument");
 
     mod.def("targetStringsMatch", &mx::targetStringsMatch);
     mod.def("prettyPrint", &mx::prettyPrint);
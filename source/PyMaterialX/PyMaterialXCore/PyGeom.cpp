@@ -88,6 +88,13 @@ void bindPyGeom(py::module& mod)
         .def("matchesGeomString", &mx::Collection::matchesGeomString)
         .def_readonly_static("CATEGORY", &mx::Collection::CATEGORY);
 
+    py::class_<mx::GeomMatcher>(mod, "GeomMatcher")
+        .def(py::init<>())
+        .def(py::init<const std::string&, bool>(),
+            py::arg("geom"), py::arg("contains") = false)
+        .def(py::init<mx::ConstCollectionPtr>())
+        .def("matchesGeomString", &mx::GeomMatcher::matchesGeomString);
+
     mod.def("geomStringsMatch", &mx::geomStringsMatch);
 
     mod.attr("GEOM_PATH_SEPARATOR") = mx::GEOM_PATH_SEPARATOR;
@@ -81,6 +81,20 @@ void bindPyLook(py::module& mod)
         .def("getVisible", &mx::Visibility::getVisible)
         .def_readonly_static("CATEGORY", &mx::Visibility::CATEGORY);
 
+    py::class_<mx::GeomAssignments>(mod, "GeomAssignments")
+        .def_readonly("materialAssigns", &mx::GeomAssignments::materialAssigns)
+        .def_readonly("propertyAssigns", &mx::GeomAssignments::propertyAssigns)
+        .def_readonly("propertySetAssigns", &mx::GeomAssignments::propertySetAssigns)
+        .def_readonly("visibilities", &mx::GeomAssignments::visibilities)
+        .def_readonly("variantAssigns", &mx::GeomAssignments::variantAssigns);
+
+    py::class_<mx::LookResolver>(mod, "LookResolver")
+        .def(py::init<mx::ConstLookPtr>())
+        .def(py::init<mx::ConstLookGroupPtr>())
+        .def("resolve", static_cast<mx::GeomAssignments (mx::LookResolver::*)(const std::string&) const>(&mx::LookResolver::resolve))
+        .def("resolve", static_cast<std::vector<mx::GeomAssignments> (mx::LookResolver::*)(const mx::StringVec&, unsigned int) const>(&mx::LookResolver::resolve),
+            py::arg("geoms"), py::arg("threadCount") = 0);
+
     mod.def("getGeometryBindings", &mx::getGeometryBindings,
         py::arg("materialNode") , py::arg("geom") = mx::UNIVERSAL_GEOM_NAME);
 }
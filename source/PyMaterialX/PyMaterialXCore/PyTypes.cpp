@@ -126,6 +126,21 @@ void bindPyTypes(py::module& mod)
         .def("transformPoint", &mx::Matrix44::transformPoint)
         .def("transformVector", &mx::Matrix44::transformVector)
         .def("transformNormal", &mx::Matrix44::transformNormal)
+        .def("transformPoints", [](const mx::Matrix44& m, std::vector<mx::Vector3> points)
+        {
+            m.transformPoints(points.data(), points.data(), points.size());
+            return points;
+        })
+        .def("transformVectors", [](const mx::Matrix44& m, std::vector<mx::Vector3> vectors)
+        {
+            m.transformVectors(vectors.data(), vectors.data(), vectors.size());
+            return vectors;
+        })
+        .def("transformNormals", [](const mx::Matrix44& m, std::vector<mx::Vector3> normals)
+        {
+            m.transformNormals(normals.data(), normals.data(), normals.size());
+            return normals;
+        })
         .def_static("createRotationX", &mx::Matrix44::createRotationX)
         .def_static("createRotationY", &mx::Matrix44::createRotationY)
         .def_static("createRotationZ", &mx::Matrix44::createRotationZ)
@@ -0,0 +1,40 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXFormat/BinaryIo.h>
+#include <MaterialXCore/Document.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyBinaryIo(py::module& mod)
+{
+    py::class_<mx::BinaryReadOptions>(mod, "BinaryReadOptions")
+        .def(py::init())
+        .def_readwrite("upgradeVersion", &mx::BinaryReadOptions::upgradeVersion);
+
+    py::class_<mx::BinaryWriteOptions>(mod, "BinaryWriteOptions")
+        .def(py::init())
+        .def_readwrite("elementPredicate", &mx::BinaryWriteOptions::elementPredicate);
+
+    mod.def("readFromBinaryFile", &mx::readFromBinaryFile,
+        py::arg("doc"), py::arg("filename"), py::arg("searchPath") = mx::FileSearchPath(), py::arg("readOptions") = (mx::BinaryReadOptions*) nullptr);
+    mod.def("readFromBinaryString", [](mx::DocumentPtr doc, const py::bytes& data, const mx::BinaryReadOptions* readOptions)
+        {
+            mx::readFromBinaryString(doc, data, readOptions);
+        },
+        py::arg("doc"), py::arg("data"), py::arg("readOptions") = (mx::BinaryReadOptions*) nullptr);
+    mod.def("writeToBinaryFile", mx::writeToBinaryFile,
+        py::arg("doc"), py::arg("filename"), py::arg("writeOptions") = (mx::BinaryWriteOptions*) nullptr);
+    mod.def("writeToBinaryString", [](mx::DocumentPtr doc, const mx::BinaryWriteOptions* writeOptions)
+        {
+            return py::bytes(mx::writeToBinaryString(doc, writeOptions));
+        },
+        py::arg("doc"), py::arg("writeOptions") = (mx::BinaryWriteOptions*) nullptr);
+
+    mod.attr("MTLX_BINARY_EXTENSION") = mx::MTLX_BINARY_EXTENSION;
+}